@@ -0,0 +1,406 @@
+// aurora_bench.cpp
+// benchmark suite
+// ns/sample, realtime multiple and state size of each class
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "../examples/grain.h"
+#include "BlOsc.h"
+#include "Conv.h"
+#include "Del.h"
+#include "Env.h"
+#include "Eq.h"
+#include "FFT.h"
+#include "Fil.h"
+#include "FourPole.h"
+#include "Noise.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include "Quad.h"
+#include "SpecPitch.h"
+#include "SpecShift.h"
+#include "SpecStream.h"
+#include "TwoPole.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <malloc.h>
+#include <memory>
+#include <string>
+
+/* heap accounting: the live heap size is tracked by replacing the
+   global allocation functions, so that the state of an object is
+   measured as the memory it allocates, including the object itself */
+static std::size_t live = 0;
+
+__attribute__((noinline)) static void *counted(void *p) {
+  if (!p)
+    throw std::bad_alloc();
+  live += malloc_usable_size(p);
+  return p;
+}
+
+__attribute__((noinline)) static void release(void *p) {
+  if (p) {
+    live -= malloc_usable_size(p);
+    std::free(p);
+  }
+}
+
+static std::size_t aligned(std::size_t n, std::align_val_t a) {
+  std::size_t al = static_cast<std::size_t>(a);
+  return (n ? n + al - 1 : al) / al * al;
+}
+
+void *operator new(std::size_t n) { return counted(std::malloc(n ? n : 1)); }
+void *operator new[](std::size_t n) { return counted(std::malloc(n ? n : 1)); }
+void *operator new(std::size_t n, std::align_val_t a) {
+  return counted(std::aligned_alloc((std::size_t)a, aligned(n, a)));
+}
+void *operator new[](std::size_t n, std::align_val_t a) {
+  return counted(std::aligned_alloc((std::size_t)a, aligned(n, a)));
+}
+void operator delete(void *p) noexcept { release(p); }
+void operator delete[](void *p) noexcept { release(p); }
+void operator delete(void *p, std::size_t) noexcept { release(p); }
+void operator delete[](void *p, std::size_t) noexcept { release(p); }
+void operator delete(void *p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { release(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  release(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  release(p);
+}
+
+using namespace Aurora;
+
+struct Result {
+  std::string name;
+  const char *type;
+  std::size_t vsize;
+  double ns;
+  std::size_t bytes;
+};
+
+/* the suite for sample type S */
+template <typename S> struct Suite {
+  const char *type;
+  double secs;
+  std::vector<Result> &res;
+  std::vector<S> in, out, out2, tab, win, ir;
+  TableSet<S> saw;
+  volatile S sink;
+
+  Suite(const char *t, double s, std::vector<Result> &r, std::size_t maxvs)
+      : type(t), secs(s), res(r), in(maxvs), out(maxvs), out2(maxvs),
+        tab(def_ftlen), win(1024), ir(4096), saw(SAW), sink(0) {
+    std::size_t n = 0;
+    for (auto &s : in)
+      s = (S)std::rand() / RAND_MAX - 0.5;
+    for (auto &s : tab)
+      s = Aurora::sin<S>((double)n++ / tab.size());
+    n = 0;
+    for (auto &s : win)
+      s = 0.5 - 0.5 * Aurora::cos<S>((double)n++ / win.size());
+    n = 0;
+    for (auto &s : ir)
+      s = ((S)std::rand() / RAND_MAX - 0.5) * std::exp(-(S)n++ / 1000);
+    Grain<S> g(tab); // allocates the grain window shared by all grains
+  }
+
+  span<const S> x(std::size_t vs) { return span<const S>(in.data(), vs); }
+  span<S> y(std::size_t vs) { return span<S>(out.data(), vs); }
+  span<S> y2(std::size_t vs) { return span<S>(out2.data(), vs); }
+
+  /* times fn(obj), processing vs samples per call, over batches
+     of calls lasting about secs/10, returning the best batch in
+     ns/sample */
+  template <typename T, typename F>
+  double timeit(T &obj, F fn, std::size_t vs) {
+    using clock = std::chrono::steady_clock;
+    std::size_t calls = 1;
+    double best = 0;
+    for (;;) {
+      auto t0 = clock::now();
+      for (std::size_t k = 0; k < calls; k++)
+        fn(obj);
+      double t = std::chrono::duration<double>(clock::now() - t0).count();
+      if (t >= secs / 10 || calls >= (1u << 30))
+        break;
+      calls *= 2;
+    }
+    for (int r = 0; r < 5; r++) {
+      auto t0 = clock::now();
+      for (std::size_t k = 0; k < calls; k++)
+        fn(obj);
+      double t =
+          std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+      t /= (double)calls * vs;
+      if (r == 0 || t < best)
+        best = t;
+    }
+    return best;
+  }
+
+  /* runs a case: make() returns the object under test, as a
+     std::unique_ptr, and fn(obj) processes vs samples with it */
+  template <typename MK, typename F>
+  void run(const std::string &name, std::size_t vs, MK make, F fn) {
+    std::size_t l0 = live;
+    auto obj = make();
+    fn(*obj); // any memory allocated on first use counts as state
+    std::size_t bytes = live - l0;
+    double ns = timeit(*obj, fn, vs);
+    res.push_back({name, type, vs, ns, bytes});
+    std::cout << "  " << name
+              << std::string(name.size() < 32 ? 32 - name.size() : 1, ' ')
+              << type << "\t" << vs << "\t" << ns << "\t"
+              << (1e9 / def_sr) / ns << "\t" << bytes << std::endl;
+  }
+
+  template <S (*FN)(double, const std::vector<S> *)>
+  void osc(const char *fn, std::size_t vs) {
+    run(std::string("Osc<") + fn + ">", vs,
+        [&]() { return std::make_unique<Osc<S, FN>>(&tab, def_sr, vs); },
+        [&](Osc<S, FN> &o) { sink = o(y(vs), 0.5, 440)[0]; });
+  }
+
+  template <void (*CF)(S, S, S, double *), S (*FN)(S, double *, double *)>
+  void fil(const char *cf, const char *fn, std::size_t vs) {
+    run(std::string("Fil<") + cf + "," + fn + ">", vs,
+        [&]() { return std::make_unique<Fil<S, CF, FN>>(def_sr, vs); },
+        [&](Fil<S, CF, FN> &f) { sink = f(y(vs), x(vs), 1000, 100)[0]; });
+  }
+
+  template <S (*FN)(S, std::size_t, const sig_vector<S> &, std::vector<S> *)>
+  void del(const char *fn, std::size_t vs, std::size_t taps = 0) {
+    struct D {
+      Del<S, FN> d;
+      std::vector<S> mem;
+      D(std::size_t vs, std::size_t taps) : d(0.1, def_sr, vs), mem(taps) {
+        for (auto &s : mem)
+          s = 1. / mem.size();
+      }
+    };
+    run(std::string("Del<") + fn + ">", vs,
+        [&]() { return std::make_unique<D>(vs, taps); },
+        [&](D &d) {
+          sink = d.d(y(vs), x(vs), 0.01, 0.5, 0,
+                     d.mem.size() ? &d.mem : nullptr)[0];
+        });
+  }
+
+  template <S (*FN)(S, std::size_t, const sig_vector<S> &, std::vector<S> *)>
+  void tap(const char *fn, std::size_t vs, Del<S> &line) {
+    run(std::string("Tap<") + fn + ">", vs,
+        [&]() { return std::make_unique<Tap<S, FN>>(def_sr, vs); },
+        [&](Tap<S, FN> &t) { sink = t(y(vs), line, 0.0123)[0]; });
+  }
+
+  void conv(std::size_t psize, bool algo, std::size_t vs) {
+    struct C {
+      IR<S> ir;
+      Conv<S> conv;
+      C(const std::vector<S> &s, std::size_t ps, bool a, std::size_t vs)
+          : ir(s, ps), conv(&ir, a, vs) {}
+    };
+    run(std::string("Conv<") + std::to_string(psize) +
+            (algo == ols ? ",ols>" : ",ola>"),
+        vs, [&]() { return std::make_unique<C>(ir, psize, algo, vs); },
+        [&](C &c) { sink = c.conv(y(vs), x(vs), 0.5)[0]; });
+  }
+
+  void fft(std::size_t size) {
+    struct F {
+      FFT<S> fft;
+      std::vector<std::complex<S>> spec;
+      F(std::size_t n) : fft(n, packed), spec(n / 2) {}
+    };
+    std::vector<S> sig(size);
+    for (auto &s : sig)
+      s = (S)std::rand() / RAND_MAX - 0.5;
+    run("FFT<forward>", size, [&]() { return std::make_unique<F>(size); },
+        [&](F &f) { sink = f.fft.transform(sig)[1].real(); });
+    run("FFT<forward+inverse>", size,
+        [&]() { return std::make_unique<F>(size); },
+        [&](F &f) {
+          auto sp = f.fft.transform(sig);
+          std::copy(sp, sp + f.spec.size(), f.spec.begin());
+          sink = f.fft.transform(f.spec)[1];
+        });
+  }
+
+  void spec(std::size_t vs) {
+    struct P {
+      SpecStream<S> anal;
+      SpecSynth<S> synth;
+      SpecShift<S> shift;
+      SpecPitch<S> pitch;
+      P(const std::vector<S> &w, std::size_t vs)
+          : anal(w, w.size() / 4), synth(w, w.size() / 4, def_sr, vs),
+            shift(def_sr, w.size()), pitch(w.size() / 4) {}
+    };
+    auto make = [&]() { return std::make_unique<P>(win, vs); };
+    run("SpecStream", vs, make,
+        [&](P &p) { sink = p.anal(x(vs))[1].amp(); });
+    run("SpecStream>SpecSynth", vs, make,
+        [&](P &p) { sink = p.synth(y(vs), p.anal(x(vs)))[0]; });
+    run("SpecStream>SpecShift>SpecSynth", vs, make, [&](P &p) {
+      p.anal(x(vs));
+      sink = p.synth(y(vs), p.shift(p.anal, 1.5))[0];
+    });
+    run("SpecStream>SpecPitch", vs, make, [&](P &p) {
+      p.anal(x(vs));
+      sink = p.pitch(p.anal, 0.01);
+    });
+  }
+
+  void all(std::size_t vs) {
+    osc<lookup>("lookup", vs);
+    osc<lookupi>("lookupi", vs);
+    osc<lookupc>("lookupc", vs);
+    osc<Aurora::sin>("sin", vs);
+    osc<Aurora::cos>("cos", vs);
+    osc<phase>("phase", vs);
+    run("BlOsc", vs,
+        [&]() { return std::make_unique<BlOsc<S>>(&saw, def_sr, vs); },
+        [&](BlOsc<S> &o) { sink = o(y(vs), 0.5, 440)[0]; });
+    S att = 0.01, dec = 0.1, sus = 0.5;
+    std::size_t blk = 0;
+    run("Env", vs,
+        [&]() {
+          return std::make_unique<Env<S>>(ads_gen(att, dec, sus), 0.1, def_sr,
+                                          vs);
+        },
+        [&](Env<S> &e) {
+          // gate on and off every 4096 samples
+          sink = e(y(vs), x(vs), ((blk++ * vs) / 4096) % 2 == 0)[0];
+        });
+    fil<lp_cfs, dfII>("lp_cfs", "dfII", vs);
+    fil<hp_cfs, dfII>("hp_cfs", "dfII", vs);
+    fil<bp_cfs, dfII>("bp_cfs", "dfII", vs);
+    fil<br_cfs, dfII>("br_cfs", "dfII", vs);
+    fil<lp_cfs, dfI>("lp_cfs", "dfI", vs);
+    fil<reson_cfs, reson>("reson_cfs", "reson", vs);
+    fil<reson_cfs1, reson>("reson_cfs1", "reson", vs);
+    fil<reson_cfs2, reson>("reson_cfs2", "reson", vs);
+    run("OnePole", vs,
+        [&]() { return std::make_unique<OnePole<S>>(def_sr, vs); },
+        [&](OnePole<S> &f) { sink = f(y(vs), x(vs), 1000)[0]; });
+    run("TwoPole", vs,
+        [&]() { return std::make_unique<TwoPole<S>>(def_sr, vs); },
+        [&](TwoPole<S> &f) { sink = f(y(vs), x(vs), 1000, 0.5)[0]; });
+    run("FourPole", vs,
+        [&]() { return std::make_unique<FourPole<S>>(def_sr, vs); },
+        [&](FourPole<S> &f) { sink = f(y(vs), x(vs), 1000, 0.5)[0]; });
+    run("Eq", vs, [&]() { return std::make_unique<Eq<S>>(def_sr, vs); },
+        [&](Eq<S> &f) { sink = f(y(vs), x(vs), 2, 1000, 500)[0]; });
+    run("Quad", vs, [&]() { return std::make_unique<Quad<S>>(def_sr, vs); },
+        [&](Quad<S> &f) { sink = f(y(vs), y2(vs), x(vs))[0]; });
+    del<fixed_delay>("fixed_delay", vs);
+    del<vdelay>("vdelay", vs);
+    del<vdelayi>("vdelayi", vs);
+    del<vdelayc>("vdelayc", vs);
+    del<lp_delay>("lp_delay", vs, 2);
+    del<fir>("fir(32)", vs, 32);
+    Del<S> line(0.1, def_sr, vs);
+    for (std::size_t n = 0; n < def_sr / 10; n += vs)
+      line(x(vs));
+    tap<vdelay>("vdelay", vs, line);
+    tap<vdelayi>("vdelayi", vs, line);
+    tap<vdelayc>("vdelayc", vs, line);
+    for (std::size_t ps : {64, 256, 1024}) {
+      conv(ps, ols, vs);
+      conv(ps, !ols, vs);
+    }
+    spec(vs);
+    run("Noise<white>", vs,
+        [&]() { return std::make_unique<Noise<S>>(def_sr, vs); },
+        [&](Noise<S> &n) { sink = n(y(vs), 0.5)[0]; });
+    run("Noise<white,1000Hz>", vs,
+        [&]() { return std::make_unique<Noise<S>>(def_sr, vs); },
+        [&](Noise<S> &n) { sink = n(y(vs), 0.5, 1000, true)[0]; });
+    run("GrainGen", vs,
+        [&]() {
+          return std::make_unique<GrainGen<S>>(tab, 16, def_sr, vs, vs);
+        },
+        [&](GrainGen<S> &g) { sink = g(0.5, 1, 100, 0.1, 0, vs)[0]; });
+  }
+};
+
+/* writes the results as JSON */
+void json(std::ostream &os, const std::vector<Result> &res) {
+  os << "{\n  \"sr\": " << def_sr << ",\n  \"results\": [\n";
+  for (std::size_t k = 0; k < res.size(); k++) {
+    auto &r = res[k];
+    os << "    {\"name\": \"" << r.name << "\", \"type\": \"" << r.type
+       << "\", \"vsize\": " << r.vsize << ", \"ns_per_sample\": " << r.ns
+       << ", \"realtime\": " << (1e9 / def_sr) / r.ns
+       << ", \"state_bytes\": " << r.bytes << "}"
+       << (k + 1 < res.size() ? ",\n" : "\n");
+  }
+  os << "  ]\n}\n";
+}
+
+int main(int argc, const char *argv[]) {
+  const char *path = argc > 1 ? argv[1] : "aurora_bench.json";
+  double secs = argc > 2 ? std::atof(argv[2]) : 0.05;
+  std::vector<std::size_t> sizes;
+  for (int k = 3; k < argc; k++)
+    if (std::atoi(argv[k]) > 0)
+      sizes.push_back(std::atoi(argv[k]));
+  if (sizes.empty())
+    sizes = {16, 64, 256, 1024};
+  std::size_t maxvs = 4096;
+  for (auto vs : sizes)
+    maxvs = vs > maxvs ? vs : maxvs;
+  std::vector<Result> res;
+  std::cout << "  case" << std::string(28, ' ')
+            << "type\tvsize\tns/samp\trealtime\tstate bytes" << std::endl;
+  {
+    Suite<float> sf("float", secs, res, maxvs);
+    for (auto vs : sizes)
+      sf.all(vs);
+    for (std::size_t n : {256, 1024, 4096})
+      sf.fft(n);
+  }
+  {
+    Suite<double> sd("double", secs, res, maxvs);
+    for (auto vs : sizes)
+      sd.all(vs);
+    for (std::size_t n : {256, 1024, 4096})
+      sd.fft(n);
+  }
+  std::ofstream f(path);
+  json(f, res);
+  if (!f) {
+    std::cout << "error: could not write " << path << std::endl;
+    return 1;
+  }
+  std::cout << res.size() << " results written to " << path << std::endl;
+  return 0;
+}
@@ -0,0 +1,182 @@
+// blep.cpp
+// polyBLEP oscillator benchmark
+// BlepOsc against BlOsc: memory, setup time, CPU time and aliasing
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#include "BlOsc.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+const std::size_t fftsize = 4096;
+
+/* alias level: energy outside the harmonics of a fundamental of
+   bins (prime) FFT bins relative to the total (dB), over fftsize
+   samples of s */
+double aliasing(const std::vector<float> &s, std::size_t bins) {
+  FFT<float> fft(fftsize);
+  std::vector<float> x(s.end() - fftsize, s.end());
+  auto sp = fft.transform(x);
+  double sig = 0, al = 0;
+  for (std::size_t k = 1; k < fftsize / 2; k++) {
+    double e = std::norm(sp[k]);
+    if (k % bins == 0)
+      sig += e;
+    else
+      al += e;
+  }
+  return 10 * std::log10(al / (sig + al));
+}
+
+/* naive (aliasing) waves, for reference */
+template <uint32_t W>
+float naive(double ph, const std::vector<float> *t = nullptr) {
+  (void)t;
+  switch (W) {
+  case SAW:
+    return 1 - 2 * ph;
+  case SQUARE:
+    return ph < .5 ? 1 : -1;
+  case TRIANGLE:
+    return 4 * std::fabs(ph - .5) - 1;
+  default:
+    return ph < .25 ? 1.5 : -.5;
+  }
+}
+
+/* two seconds of oscillator O at f, into a vector */
+template <typename O> std::vector<float> render(O &osc, float f) {
+  std::vector<float> s;
+  osc.reset(def_sr);
+  for (std::size_t n = 0; n < 2 * def_sr / def_vsize; n++) {
+    auto &v = osc(0.5f, f);
+    s.insert(s.end(), v.begin(), v.end());
+  }
+  return s;
+}
+
+template <uint32_t W>
+bool bench(const char *name, std::size_t vsize, std::size_t blocks) {
+  const std::size_t bins[] = {97, 467};
+  std::vector<float> out(vsize);
+  volatile float sink = 0;
+
+  auto t0 = std::chrono::steady_clock::now();
+  TableSet<float> waves(W);
+  auto t1 = std::chrono::steady_clock::now();
+  double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+  std::size_t nt = (std::size_t)std::log2(def_sr / def_base);
+  double kb = nt * (Table<float>::pad + def_ftlen + Table<float>::gend) *
+              sizeof(float) / 1024.;
+
+  BlOsc<float> bosc(&waves, def_sr, vsize);
+  BlepOsc<float> posc(W, def_sr, vsize);
+  Osc<float, naive<W>> nosc(def_sr, vsize);
+  posc.width(0.25);
+  double tb = nsps([&]() { sink = bosc(span<float>(out), 0.5f, 441.f)[0]; },
+                   vsize, blocks);
+  double tp = nsps([&]() { sink = posc(span<float>(out), 0.5f, 441.f)[0]; },
+                   vsize, blocks);
+  (void)sink;
+
+  std::cout << name << std::endl;
+  std::cout << "  BlOsc\t\t" << tb << " ns/sample, " << kb
+            << " KB of tables, built in " << ms << " ms" << std::endl;
+  std::cout << "  BlepOsc\t" << tp << " ns/sample, " << sizeof(posc)
+            << " bytes of state, no tables" << std::endl;
+
+  bool ok = true;
+  for (auto b : bins) {
+    float f = b * def_sr / fftsize;
+    double an, ab, ap, am;
+    {
+      BlOsc<float> o(&waves);
+      ab = aliasing(render(o, f), b);
+    }
+    {
+      BlepOsc<float> o(W);
+      o.width(0.25);
+      ap = aliasing(render(o, f), b);
+      am = aliasing(render(o, -f), b);
+    }
+    {
+      Osc<float, naive<W>> o;
+      an = aliasing(render(o, f), b);
+    }
+    std::cout << "  aliasing at " << f << " Hz (dB): naive " << an
+              << ", BlOsc " << ab << ", BlepOsc " << ap << " (" << am
+              << " at " << -f << " Hz)" << std::endl;
+    /* the corrections have to take off most of the aliasing, for
+       either sign of the frequency */
+    ok = ok && ap < an - 10 && std::fabs(am - ap) < 0.5;
+  }
+  if (!ok)
+    std::cout << "error: BlepOsc aliasing too high" << std::endl;
+  return ok;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  bool ok = true;
+  std::cout << "bandlimited oscillators, vsize = " << vsize << std::endl;
+  ok = bench<SAW>("SAW", vsize, blocks) && ok;
+  ok = bench<SQUARE>("SQUARE", vsize, blocks) && ok;
+  ok = bench<TRIANGLE>("TRIANGLE", vsize, blocks) && ok;
+  ok = bench<PULSE>("PULSE (BlepOsc width 0.25)", vsize, blocks) && ok;
+
+  /* pulse width modulation at audio rate */
+  BlepOsc<float> pwm(PULSE, def_sr, vsize);
+  std::vector<float> out(vsize), w(vsize);
+  for (std::size_t n = 0; n < vsize; n++)
+    w[n] = 0.5 + 0.4 * std::sin(twopi * n / vsize);
+  volatile float sink = 0;
+  double t = nsps(
+      [&]() { sink = pwm.pwm(span<float>(out), 0.5f, 441.f, w)[0]; }, vsize,
+      blocks);
+  (void)sink;
+  std::cout << "PWM\n  BlepOsc\t" << t << " ns/sample" << std::endl;
+  return ok ? 0 : 1;
+}
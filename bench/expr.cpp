@@ -0,0 +1,134 @@
+// expr.cpp
+// Signal expression benchmark:
+// BinOp/Mix/Func chains vs fused expressions
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#include "Expr.h"
+#include "Func.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Aurora;
+
+bool ok = true;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+/* runs a chain of objects (obj()) against the fused expression
+   (fused()), checks that outputs match bit for bit and prints
+   the cost per sample
+*/
+template <typename S, typename O, typename F>
+void run(const char *name, std::size_t vsize, std::size_t blocks, O obj,
+         F fused) {
+  {
+    auto &a = obj();
+    auto &b = fused();
+    if (a.size() != b.size() ||
+        std::memcmp(a.data(), b.data(), a.size() * sizeof(S))) {
+      std::cout << name << ": mismatch" << std::endl;
+      ok = false;
+      return;
+    }
+  }
+  volatile S sink = 0;
+  double a = nsps([&]() { sink = obj()[0]; }, vsize, blocks);
+  double b = nsps([&]() { sink = fused()[0]; }, vsize, blocks);
+  (void)sink;
+  std::cout << name << a << " ns/sample -> " << b << " ns/sample (x" << a / b
+            << ")" << std::endl;
+}
+
+template <typename S>
+void bench(const char *type, std::size_t vsize, std::size_t blocks) {
+  std::vector<std::vector<S>> in(4, std::vector<S>(vsize));
+  for (auto &v : in)
+    for (auto &s : v)
+      s = (S)std::rand() / RAND_MAX - 0.5;
+  auto &a = in[0], &b = in[1], &c = in[2], &d = in[3];
+  Mix<S> mix(vsize);
+  BinOp<S, times> gain(vsize), amp(vsize);
+  BinOp<S, plus> add(vsize);
+  Func<S, clip> clp(vsize);
+  Eval<S> eval(vsize);
+  std::cout << type << " objects -> fused, vsize = " << vsize << std::endl;
+
+  run<S>(
+      "  g*(a+b+c+d)  ", vsize, blocks,
+      [&]() -> const sig_vector<S> & {
+        return gain(0.25, mix(a, b, c, d));
+      },
+      [&]() -> const sig_vector<S> & {
+        return eval(0.25 * (lazy(a) + lazy(b) + lazy(c) + lazy(d)));
+      });
+
+  run<S>(
+      "  g*(a*b)      ", vsize, blocks,
+      [&]() -> const sig_vector<S> & { return gain(0.5, amp(a, b)); },
+      [&]() -> const sig_vector<S> & {
+        return eval(0.5 * (lazy(a) * lazy(b)));
+      });
+
+  run<S>(
+      "  clip(a*b+c)  ", vsize, blocks,
+      [&]() -> const sig_vector<S> & { return clp(add(amp(a, b), c)); },
+      [&]() -> const sig_vector<S> & {
+        return eval(func<clip<S>>(lazy(a) * lazy(b) + lazy(c)));
+      });
+
+  /* in place: the output is also an operand */
+  std::vector<S> io(a), ref(vsize);
+  for (std::size_t n = 0; n < vsize; n++)
+    ref[n] = rect(c[n]) + a[n];
+  eval(span<S>(io), func<rect<S>>(lazy(c)) + lazy(io));
+  if (std::memcmp(io.data(), ref.data(), vsize * sizeof(S))) {
+    std::cout << "  in place: mismatch" << std::endl;
+    ok = false;
+  }
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 100000;
+  bench<float>("float ", vsize, blocks);
+  bench<double>("double", vsize, blocks);
+  return ok ? 0 : 1;
+}
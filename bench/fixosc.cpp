@@ -0,0 +1,177 @@
+// fixosc.cpp
+// fixed-point oscillator benchmark
+// FixOsc against Osc: agreement, time per overload and bank time
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+/* max abs difference between oscillators O1 and O2 over one second,
+   driven through the (am, fm, pm) path with a vibrato and phase
+   modulation */
+template <typename O1, typename O2> double maxdiff(O1 &o1, O2 &o2) {
+  std::vector<float> am(def_vsize, 0.5f), fm(def_vsize), pm(def_vsize);
+  double d = 0;
+  o1.reset(def_sr);
+  o2.reset(def_sr);
+  for (std::size_t b = 0, t = 0; b < def_sr / def_vsize; b++) {
+    for (std::size_t n = 0; n < def_vsize; n++, t++) {
+      fm[n] = 441 + 20 * std::sin(twopi * 5 * t / def_sr);
+      pm[n] = 0.1 * std::sin(twopi * 3 * t / def_sr);
+    }
+    auto &s1 = o1(span<const float>(am), span<const float>(fm), 0);
+    auto &s2 = o2(span<const float>(am), span<const float>(fm), 0);
+    for (std::size_t n = 0; n < def_vsize; n++)
+      d = std::max(d, (double)std::fabs(s1[n] - s2[n]));
+    auto &p1 = o1(0.5f, 441.f, span<const float>(pm));
+    auto &p2 = o2(0.5f, 441.f, span<const float>(pm));
+    for (std::size_t n = 0; n < def_vsize; n++)
+      d = std::max(d, (double)std::fabs(p1[n] - p2[n]));
+  }
+  return d;
+}
+
+/* times the six processing overloads of oscillator O */
+template <typename O>
+void bench(const char *name, O &osc, std::size_t vsize, std::size_t blocks) {
+  const float a = 0.5, f = 441;
+  std::vector<float> am(vsize, a), fm(vsize, f), pm(vsize, 0);
+  std::vector<float> out(vsize);
+  const char *args[] = {"a, f", "a, fm", "am, f", "am, fm", "a, f, pm",
+                        "am, f, pm"};
+  auto run = [&](int k, span<float> o) {
+    switch (k) {
+    case 0:
+      return osc(o, a, f);
+    case 1:
+      return osc(o, a, span<const float>(fm));
+    case 2:
+      return osc(o, span<const float>(am), f);
+    case 3:
+      return osc(o, span<const float>(am), span<const float>(fm));
+    case 4:
+      return osc(o, a, f, span<const float>(pm));
+    default:
+      return osc(o, span<const float>(am), f, span<const float>(pm));
+    }
+  };
+  volatile float sink = 0;
+  std::cout << name;
+  for (int k = 0; k < 6; k++) {
+    double t = nsps([&]() { sink = run(k, span<float>(out))[0]; }, vsize,
+                    blocks);
+    std::cout << "\t(" << args[k] << "): " << t;
+  }
+  (void)sink;
+  std::cout << " ns/sample" << std::endl;
+}
+
+/* a bank of nos oscillators O at inharmonic frequencies, summed,
+   in ns per oscillator per sample */
+template <typename O>
+double bank(std::vector<O> &oscs, std::size_t vsize, std::size_t blocks) {
+  std::vector<float> out(vsize), mix(vsize);
+  volatile float sink = 0;
+  double t = nsps(
+      [&]() {
+        std::fill(mix.begin(), mix.end(), 0.f);
+        std::size_t k = 0;
+        for (auto &o : oscs) {
+          o(span<float>(out), 0.01f, 100.f + 37.3f * k++);
+          for (std::size_t n = 0; n < vsize; n++)
+            mix[n] += out[n];
+        }
+        sink = mix[0];
+      },
+      vsize, blocks);
+  (void)sink;
+  return t / oscs.size();
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  std::size_t nos = argc > 3 ? std::atoi(argv[3]) : 256;
+  if (vsize < 1)
+    vsize = 1;
+  if (nos < 1)
+    nos = 1;
+  bool ok = true;
+  std::vector<float> tab(def_ftlen);
+  for (std::size_t n = 0; n < tab.size(); n++)
+    tab[n] = std::sin(twopi * n / def_ftlen);
+  Table<float> gtab(tab);
+
+  Osc<float, lookupi> iosc(&tab);
+  Osc<float, lookupc> cosc(&tab);
+  FixOsc<float, lookupi> fiosc(&gtab);
+  FixOsc<float, lookupc> fcosc(&gtab);
+  FixOsc<float, lookuph> fhosc(&gtab);
+
+  /* interpolation and phase rounding differences only */
+  double di = maxdiff(iosc, fiosc), dc = maxdiff(cosc, fcosc);
+  std::cout << "FixOsc against Osc, max abs diff: lookupi " << di
+            << ", lookupc " << dc << std::endl;
+  if (di > 1e-5 || dc > 1e-5) {
+    std::cout << "error: FixOsc does not match Osc" << std::endl;
+    ok = false;
+  }
+
+  std::cout << "oscillators, vsize = " << vsize << std::endl;
+  bench("Osc lookupi", iosc, vsize, blocks);
+  bench("FixOsc lookupi", fiosc, vsize, blocks);
+  bench("Osc lookupc", cosc, vsize, blocks);
+  bench("FixOsc lookupc", fcosc, vsize, blocks);
+  bench("FixOsc lookuph", fhosc, vsize, blocks);
+
+  std::vector<Osc<float, lookupi>> obank(nos, Osc<float, lookupi>(&tab));
+  std::vector<FixOsc<float, lookupi>> fbank(nos,
+                                            FixOsc<float, lookupi>(&gtab));
+  std::size_t bb = blocks / nos ? blocks / nos : 1;
+  double to = bank(obank, vsize, bb), tf = bank(fbank, vsize, bb);
+  std::cout << "bank of " << nos << ", lookupi: Osc " << to << ", FixOsc "
+            << tf << " ns/osc/sample" << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,501 @@
+// golden.cpp
+// golden-output regression harness
+// renders every example and compares it with reference files
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "BlOsc.h"
+#include "Conv.h"
+#include "Del.h"
+#include "Env.h"
+#include "Eq.h"
+#include "Expr.h"
+#include "Fil.h"
+#include "FourPole.h"
+#include "Func.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include "Quad.h"
+#include "Resample.h"
+#include "TwoPole.h"
+#include "../examples/flute.h"
+#include "../examples/grain.h"
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sndfile.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Each example is compiled into its own namespace, with its main()
+   renamed to run(), so that it can be called with a fixed set of
+   arguments. Classes that examples add to namespace Aurora go into
+   a nested Aurora namespace, which also sees the library's. The
+   soundfile examples use the in-memory sndfile.h in bench/sndfile,
+   so no soundfile library is needed.
+*/
+namespace ex_custom {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/custom.cpp"
+#undef main
+} // namespace ex_custom
+namespace ex_drive {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/drive.cpp"
+#undef main
+} // namespace ex_drive
+namespace ex_stackedfm {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/stackedfm.cpp"
+#undef main
+} // namespace ex_stackedfm
+namespace ex_stackedpm {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/stackedpm.cpp"
+#undef main
+} // namespace ex_stackedpm
+namespace ex_operatorpm {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/operatorpm.cpp"
+#undef main
+} // namespace ex_operatorpm
+namespace ex_lopass {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/lopass.cpp"
+#undef main
+} // namespace ex_lopass
+namespace ex_lpwave {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/lpwave.cpp"
+#undef main
+} // namespace ex_lpwave
+namespace ex_wave {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/wave.cpp"
+#undef main
+} // namespace ex_wave
+namespace ex_svfdrive {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/svfdrive.cpp"
+#undef main
+} // namespace ex_svfdrive
+namespace ex_oscil {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/oscil.cpp"
+#undef main
+} // namespace ex_oscil
+namespace ex_karplus {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/karplus.cpp"
+#undef main
+} // namespace ex_karplus
+namespace ex_pwm {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/pwm.cpp"
+#undef main
+} // namespace ex_pwm
+namespace ex_noise {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/noise.cpp"
+#undef main
+} // namespace ex_noise
+namespace ex_buffer {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/buffer.cpp"
+#undef main
+} // namespace ex_buffer
+namespace ex_grsynth {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/grsynth.cpp"
+#undef main
+} // namespace ex_grsynth
+namespace ex_objvec {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/objvec.cpp"
+#undef main
+} // namespace ex_objvec
+namespace ex_freqshift {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/freqshift.cpp"
+#undef main
+} // namespace ex_freqshift
+namespace ex_tvconv {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/tvconv.cpp"
+#undef main
+} // namespace ex_tvconv
+namespace ex_delay {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/delay.cpp"
+#undef main
+} // namespace ex_delay
+namespace ex_filter {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/filter.cpp"
+#undef main
+} // namespace ex_filter
+namespace ex_reverb {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/reverb.cpp"
+#undef main
+} // namespace ex_reverb
+namespace ex_flanger {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/flanger.cpp"
+#undef main
+} // namespace ex_flanger
+namespace ex_chorus {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/chorus.cpp"
+#undef main
+} // namespace ex_chorus
+namespace ex_follow {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/follow.cpp"
+#undef main
+} // namespace ex_follow
+namespace ex_equaliser {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/equaliser.cpp"
+#undef main
+} // namespace ex_equaliser
+namespace ex_freverb {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/freverb.cpp"
+#undef main
+} // namespace ex_freverb
+namespace ex_resonator {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/resonator.cpp"
+#undef main
+} // namespace ex_resonator
+namespace ex_grproc {
+namespace Aurora {
+using namespace ::Aurora;
+}
+#define main run
+#include "../examples/grproc.cpp"
+#undef main
+} // namespace ex_grproc
+
+/* a golden test: an example, its arguments and its tolerances */
+struct Test {
+  const char *name;
+  int (*run)(int, const char **);
+  std::vector<const char *> args;
+  bool text;    // ASCII output to stdout, otherwise soundfile out.wav
+  double maxerr; // maximum absolute error
+  double snr;    // minimum signal-to-error ratio (dB)
+};
+
+const std::vector<Test> tests = {
+    {"custom", ex_custom::run, {"0.5", "0.5", "220"}, true, 1e-4, 90},
+    {"drive", ex_drive::run, {"0.5", "0.5", "220", "2"}, true, 1e-4, 90},
+    {"stackedfm", ex_stackedfm::run, {"0.5", "0.5", "220"}, true, 1e-4, 80},
+    {"stackedpm", ex_stackedpm::run, {"0.5", "0.5", "220"}, true, 1e-4, 80},
+    {"operatorpm", ex_operatorpm::run, {"0.5", "0.5", "220"}, true, 1e-4, 80},
+    {"lopass", ex_lopass::run, {"0.5", "0.5", "220", "2000"}, true, 1e-4, 90},
+    {"lpwave",
+     ex_lpwave::run,
+     {"0.5", "0.5", "220", "1000", "0.5"},
+     true,
+     1e-4,
+     90},
+    {"wave", ex_wave::run, {"0.5", "0.5", "220", "1"}, true, 1e-4, 90},
+    {"svfdrive",
+     ex_svfdrive::run,
+     {"0.5", "0.5", "220", "1000", "0.5", "1", "0"},
+     true,
+     1e-3,
+     70},
+    {"oscil", ex_oscil::run, {"0.5", "0.5", "220"}, true, 1e-4, 90},
+    {"karplus", ex_karplus::run, {"0.5", "0.5", "220"}, true, 1e-3, 70},
+    {"pwm", ex_pwm::run, {"0.5", "0.5", "220", "0.3"}, true, 1e-4, 90},
+    {"noise", ex_noise::run, {"0.5", "0.5"}, true, 1e-4, 90},
+    {"buffer", ex_buffer::run, {"0.5", "256"}, true, 1e-4, 90},
+    {"grsynth",
+     ex_grsynth::run,
+     {"0.5", "0.5", "220", "50", "0.05"},
+     true,
+     1e-4,
+     90},
+    {"objvec",
+     ex_objvec::run,
+     {"0.5", "0.5", "220", "330", "2"},
+     true,
+     1e-4,
+     90},
+    {"filter", ex_filter::run, {"in.wav", "out.wav", "1000", "0.5"}, false,
+     1e-4, 80},
+    {"delay", ex_delay::run, {"in.wav", "out.wav", "0.1", "0.5"}, false, 1e-4,
+     90},
+    {"reverb", ex_reverb::run, {"ir.wav", "in.wav", "out.wav", "0.5"}, false,
+     1e-3, 70},
+    {"tvconv",
+     ex_tvconv::run,
+     {"ir.wav", "in.wav", "out.wav", "1024", "0.5"},
+     false,
+     1e-3,
+     70},
+    {"flanger",
+     ex_flanger::run,
+     {"in.wav", "out.wav", "10", "0.5", "0.7", "0.5"},
+     false,
+     1e-4,
+     80},
+    {"chorus", ex_chorus::run, {"in.wav", "out.wav"}, false, 1e-4, 80},
+    {"follow", ex_follow::run, {"in.wav", "ir.wav", "out.wav", "1"}, false,
+     1e-4, 80},
+    {"equaliser", ex_equaliser::run, {"eq.txt", "in.wav", "out.wav"}, false,
+     1e-4, 80},
+    {"freverb",
+     ex_freverb::run,
+     {"in.wav", "out.wav", "1", "0.5", "5000"},
+     false,
+     1e-3,
+     70},
+    {"resonator", ex_resonator::run, {"in.wav", "out.wav", "500", "50"}, false,
+     1e-4, 80},
+    {"grproc",
+     ex_grproc::run,
+     {"in.wav", "out.wav", "0.5", "1.5", "1", "0.05", "4"},
+     false,
+     1e-4,
+     90},
+    {"freqshift", ex_freqshift::run, {"in.wav", "out.wav", "100"}, false, 1e-3,
+     70}};
+
+/* deterministic inputs for the soundfile examples:
+   in.wav: decaying harmonic tones with a noise burst
+   ir.wav: exponentially-decaying noise, as an impulse response
+   eq.txt: equaliser bands (gain, centre frequency, bandwidth)
+*/
+void make_inputs(const std::string &eqfile) {
+  const int sr = 44100;
+  uint32_t seed = 1;
+  auto rnd = [&seed]() {
+    seed = seed * 1664525 + 1013904223;
+    return seed / 2147483648. - 1.;
+  };
+  sf_file in, ir;
+  in.data.resize(sr);
+  for (std::size_t n = 0; n < in.data.size(); n++) {
+    double t = n / double(sr);
+    double f = t < 0.5 ? 220 : 330, s = 0;
+    for (int k = 1; k <= 8; k++)
+      s += std::sin(2 * M_PI * f * k * t) / k;
+    s *= 0.3 * std::exp(-4 * std::fmod(t, 0.5));
+    if (t > 0.25 && t < 0.3)
+      s += 0.2 * rnd();
+    in.data[n] = s;
+  }
+  ir.data.resize(sr);
+  for (std::size_t n = 0; n < ir.data.size(); n++)
+    ir.data[n] = 0.5 * rnd() * std::exp(-8. * n / sr);
+  sf_files()["in.wav"] = in;
+  sf_files()["ir.wav"] = ir;
+  std::ofstream eq(eqfile);
+  eq << "2  200  100\n0.5  1000  500\n1.5  4000  2000\n";
+}
+
+/* run a test, returning its output */
+bool render(const Test &t, const std::string &eqfile,
+            std::vector<float> &out) {
+  std::vector<const char *> argv({t.name});
+  for (auto a : t.args)
+    argv.push_back(std::string(a) == "eq.txt" ? eqfile.c_str() : a);
+  std::srand(1);
+  out.clear();
+  if (t.text) {
+    std::stringstream ss;
+    auto buf = std::cout.rdbuf(ss.rdbuf());
+    auto prec = std::cout.precision(9);
+    int res = t.run(argv.size(), argv.data());
+    std::cout.rdbuf(buf);
+    std::cout.precision(prec);
+    float s;
+    while (ss >> s)
+      out.push_back(s);
+    return res == 0 && ss.eof();
+  }
+  sf_files().erase("out.wav");
+  int res = t.run(argv.size(), argv.data());
+  out = sf_files()["out.wav"].data;
+  return res == 0;
+}
+
+int main(int argc, const char **argv) {
+  std::string mode = argc > 1 ? argv[1] : "";
+  std::string dir = argc > 2 ? argv[2] : "golden";
+  if (mode != "record" && mode != "check") {
+    std::cout << "usage: " << argv[0] << " record|check [dir] [tests...]\n";
+    return -1;
+  }
+  auto eqfile =
+      (std::filesystem::temp_directory_path() / "aurora_golden_eq.txt")
+          .string();
+  make_inputs(eqfile);
+  if (mode == "record")
+    std::filesystem::create_directories(dir);
+  int fails = 0, count = 0;
+  for (auto &t : tests) {
+    bool sel = argc < 4;
+    for (int i = 3; i < argc; i++)
+      sel = sel || t.name == std::string(argv[i]);
+    if (!sel)
+      continue;
+    count++;
+    std::vector<float> out, ref;
+    std::string file = dir + "/" + t.name + ".f32";
+    bool ok = render(t, eqfile, out) && out.size() > 0;
+    if (!ok) {
+      std::cout << t.name << ": FAILED to render\n";
+      fails++;
+      continue;
+    }
+    if (mode == "record") {
+      std::ofstream f(file, std::ios::binary);
+      f.write((const char *)out.data(), out.size() * sizeof(float));
+      ok = f.good();
+      std::cout << t.name << ": " << (ok ? "recorded " : "FAILED to write ")
+                << out.size() << " samples\n";
+      fails += !ok;
+      continue;
+    }
+    std::ifstream f(file, std::ios::binary | std::ios::ate);
+    if (!f) {
+      std::cout << t.name << ": FAILED, no reference " << file << "\n";
+      fails++;
+      continue;
+    }
+    ref.resize(f.tellg() / sizeof(float));
+    f.seekg(0);
+    f.read((char *)ref.data(), ref.size() * sizeof(float));
+    double err = 0, sig = 0, noise = 0;
+    for (std::size_t n = 0; n < ref.size() && n < out.size(); n++) {
+      double e = std::fabs(out[n] - ref[n]);
+      if (!(e <= err))
+        err = e; // catches NaNs
+      sig += ref[n] * ref[n];
+      noise += e * e;
+    }
+    double snr = noise > 0 ? 10 * std::log10(sig / noise) : INFINITY;
+    ok = out.size() == ref.size() && err <= t.maxerr && snr >= t.snr;
+    std::cout << t.name << ": " << (ok ? "ok" : "FAILED") << " (samples "
+              << out.size() << "/" << ref.size() << ", max error " << err
+              << ", SNR " << snr << " dB)\n";
+    fails += !ok;
+  }
+  std::remove(eqfile.c_str());
+  std::cout << count - fails << "/" << count << " passed\n";
+  return fails ? 1 : 0;
+}
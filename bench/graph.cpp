@@ -0,0 +1,152 @@
+// graph.cpp
+// processing graph benchmark
+// hand-wired objects vs scheduled graph with buffer reuse
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Graph.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+/* a bank of voices (oscillator -> lowpass filter), summed
+   by a chain of adders: three objects per voice
+*/
+template <typename S> struct Voices {
+  std::vector<Osc<S>> osc;
+  std::vector<OnePole<S>> fil;
+  std::vector<BinOp<S, plus>> add;
+  std::vector<S> fr;
+
+  Voices(std::size_t voices, std::size_t vsize)
+      : osc(voices, Osc<S>(def_sr, vsize)),
+        fil(voices, OnePole<S>(def_sr, vsize)),
+        add(voices, BinOp<S, plus>(vsize)), fr(voices) {
+    for (std::size_t n = 0; n < voices; n++)
+      fr[n] = 100 + 37 * n;
+  }
+
+  std::size_t footprint() const {
+    std::size_t bytes = 0;
+    for (std::size_t n = 0; n < osc.size(); n++)
+      bytes += (osc[n].vector().capacity() + fil[n].vector().capacity() +
+                add[n].vector().capacity()) *
+               sizeof(S);
+    return bytes;
+  }
+
+  const sig_vector<S> &operator()() {
+    const sig_vector<S> *s = &fil[0](osc[0](0.01, fr[0]), 1000);
+    for (std::size_t n = 1; n < osc.size(); n++)
+      s = &add[n](*s, fil[n](osc[n](0.01, fr[n]), 1000));
+    return *s;
+  }
+
+  /* the same patch as graph nodes */
+  void patch(Graph<S> &g) {
+    typename Graph<S>::Port p;
+    for (std::size_t n = 0; n < osc.size(); n++) {
+      g.uses(osc[n]);
+      g.uses(fil[n]);
+      g.uses(add[n]);
+      auto o = g.node(
+          [this, n](span<S> out) { return osc[n](out, 0.01, fr[n]); });
+      auto f = g.node(
+          [this, n](span<S> out, span<const S> in) {
+            return fil[n](out, in, 1000);
+          },
+          o);
+      p = n == 0 ? f
+                 : g.node(
+                       [this, n](span<S> out, span<const S> a,
+                                 span<const S> b) { return add[n](out, a, b); },
+                       p, f);
+    }
+    g.output(p);
+  }
+};
+
+template <typename S>
+bool bench(const char *type, std::size_t voices, std::size_t vsize,
+           std::size_t blocks) {
+  Voices<S> wired(voices, vsize);
+  Voices<S> nodes(voices, 0);
+  Graph<S> graph(vsize);
+  nodes.patch(graph);
+  if (!graph.compile()) {
+    std::cout << type << ": graph compilation failed" << std::endl;
+    return false;
+  }
+  for (int n = 0; n < 4; n++) {
+    auto &a = wired();
+    auto &b = graph();
+    if (a.size() != b.size() ||
+        std::memcmp(a.data(), b.data(), a.size() * sizeof(S))) {
+      std::cout << type << ": mismatch" << std::endl;
+      return false;
+    }
+  }
+  volatile S sink = 0;
+  double a = nsps([&]() { sink = wired()[0]; }, vsize, blocks);
+  double b = nsps([&]() { sink = graph()[0]; }, vsize, blocks);
+  (void)sink;
+  std::cout << type << " " << graph.size() << " nodes, vsize = " << vsize
+            << std::endl;
+  std::cout << "  memory: " << wired.footprint() << " bytes -> "
+            << graph.footprint() << " bytes (" << graph.buffers()
+            << " buffers)" << std::endl;
+  std::cout << "  time:   " << a << " ns/sample -> " << b << " ns/sample (x"
+            << a / b << ", " << (b - a) * vsize / graph.size()
+            << " ns per node and block)" << std::endl;
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t voices = argc > 1 ? std::atoi(argv[1]) : 100;
+  std::size_t vsize = argc > 2 ? std::atoi(argv[2]) : def_vsize;
+  std::size_t blocks = argc > 3 ? std::atoi(argv[3]) : 500;
+  bool ok = bench<float>("float ", voices, vsize, blocks);
+  ok = bench<double>("double", voices, vsize, blocks) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// mix.cpp
+// mixer benchmark
+// per-input object passes vs single-pass Mix and Bus
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "SndBase.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+using namespace Aurora;
+
+const std::size_t N = 32;
+bool ok = true;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+template <typename S> bool same(span<const S> a, span<const S> b) {
+  return a.size() == b.size() &&
+         !std::memcmp(a.data(), b.data(), a.size() * sizeof(S));
+}
+
+/* NaN inputs must not be taken for silence: every skipping path
+   (plus, times, Mix, Bus) is checked to pass NaN through */
+template <typename S> void nans(const char *type, std::size_t vsize) {
+  const S nan = std::numeric_limits<S>::quiet_NaN();
+  std::vector<S> x(vsize, nan), z(vsize, 0);
+  BinOp<S, plus> add(vsize);
+  BinOp<S, times> mul(vsize);
+  Mix<S> mix(vsize);
+  Bus<S> bus(2, vsize);
+  std::vector<span<const S>> list{x, z};
+  std::vector<S> g{1, 1};
+  bus.gains(g);
+  auto passes = [&](const sig_vector<S> &s, const SndBase<S> &o) {
+    for (auto v : s)
+      if (v == v)
+        return false;
+    return !o.silent();
+  };
+  if (!passes(add((S)0, x), add) || !passes(add(x, z), add) ||
+      !passes(mul((S)2, x), mul) || !passes(mul((S)0, x), mul) ||
+      !passes(mul(x, z), mul) || !passes(mix(x, z), mix) ||
+      !passes(bus(list, g), bus)) {
+    std::cout << type << ": NaN input taken for silence" << std::endl;
+    ok = false;
+  }
+}
+
+template <typename S>
+void bench(const char *type, std::size_t vsize, std::size_t blocks) {
+  std::vector<std::vector<S>> in(N, std::vector<S>(vsize));
+  std::array<S, N> g;
+  channels<S, N> ch;
+  std::vector<span<const S>> list(N);
+  for (std::size_t k = 0; k < N; k++) {
+    for (auto &s : in[k])
+      s = (S)std::rand() / RAND_MAX - 0.5;
+    g[k] = (S)std::rand() / RAND_MAX;
+    ch[k] = list[k] = in[k];
+  }
+  std::vector<S> gv(g.begin(), g.end()), up(N), down(N);
+  for (std::size_t k = 0; k < N; k++) {
+    up[k] = g[k] * 2;
+    down[k] = g[k];
+  }
+
+  /* one gain and one accumulation pass per input */
+  std::vector<BinOp<S, times>> gain(N, BinOp<S, times>(vsize));
+  BinOp<S, plus> add(vsize);
+  sig_vector<S> acc(vsize);
+  auto passes = [&]() -> const sig_vector<S> & {
+    acc = gain[0](g[0], in[0]);
+    for (std::size_t k = 1; k < N; k++)
+      acc = add(acc, gain[k](g[k], in[k]));
+    return acc;
+  };
+  Mix<S> mix(vsize);
+  auto mixer = [&]() -> const sig_vector<S> & { return mix(g, ch); };
+  Bus<S> bus(N, vsize), ramp(N, vsize);
+  bus.gains(gv);
+  auto buss = [&]() -> const sig_vector<S> & { return bus(list, gv); };
+  bool flip = false;
+  auto ramps = [&]() -> const sig_vector<S> & {
+    flip = !flip;
+    return ramp(list, flip ? up : down);
+  };
+
+  /* ramp reference, computed per sample */
+  ramp.gains(down);
+  std::vector<S> ref(vsize, 0);
+  for (std::size_t k = 0; k < N; k++)
+    for (std::size_t n = 0; n < vsize; n++) {
+      S r = S(n) * ((up[k] - down[k]) * (S(1) / vsize)) + down[k];
+      ref[n] = k ? in[k][n] * r + ref[n] : in[k][n] * r;
+    }
+  if (!same<S>(passes(), mixer()) || !same<S>(passes(), buss()) ||
+      !same<S>(ramps(), ref)) {
+    std::cout << type << ": mismatch" << std::endl;
+    ok = false;
+    return;
+  }
+
+  volatile S sink = 0;
+  double a = nsps([&]() { sink = passes()[0]; }, vsize, blocks);
+  double b = nsps([&]() { sink = mixer()[0]; }, vsize, blocks);
+  double c = nsps([&]() { sink = buss()[0]; }, vsize, blocks);
+  double d = nsps([&]() { sink = ramps()[0]; }, vsize, blocks);
+  (void)sink;
+  std::cout << type << " " << N << " inputs, vsize = " << vsize << std::endl;
+  std::cout << "  per-input passes " << a << " ns/sample" << std::endl;
+  std::cout << "  Mix (weighted)   " << b << " ns/sample (x" << a / b << ")"
+            << std::endl;
+  std::cout << "  Bus              " << c << " ns/sample (x" << a / c << ")"
+            << std::endl;
+  std::cout << "  Bus (ramps)      " << d << " ns/sample (x" << a / d << ")"
+            << std::endl;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  nans<float>("float ", vsize);
+  nans<double>("double", vsize);
+  bench<float>("float ", vsize, blocks);
+  bench<double>("double", vsize, blocks);
+  return ok ? 0 : 1;
+}
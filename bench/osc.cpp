@@ -0,0 +1,281 @@
+// osc.cpp
+// oscillator benchmark
+// time per sample of each Osc and BlOsc processing overload
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "BlOsc.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Aurora;
+
+/* reference oscillator with the design OscBase replaced: virtual
+   synth() and reset_obj(), called through the processing lambda,
+   with the same per-sample arithmetic */
+template <typename T, float (*FN)(double, const T *)>
+class VirtOsc : public SndBase<float> {
+  using SndBase<float>::process;
+
+protected:
+  double ph;
+  float ts;
+  const T *tab;
+
+  float step(float a, float f, double &phs, const T *t, float pm) {
+    phs += pm;
+    while (phs < 0)
+      phs += 1.;
+    while (phs >= 1.)
+      phs -= 1.;
+    float s = (float)(a * FN(phs, t));
+    phs = f * ts + phs - pm;
+    return s;
+  }
+
+  virtual float synth(float a, float f, double &phs, const T *t, float pm) {
+    return step(a, f, phs, t, pm);
+  }
+
+  virtual void reset_obj(float fs) {
+    ts = 1 / fs;
+    ph = 0;
+  }
+
+public:
+  VirtOsc(const T *t)
+      : SndBase<float>(def_vsize), ph(0), ts(1 / def_sr), tab(t) {}
+  virtual ~VirtOsc() {}
+
+  void reset(float fs) { reset_obj(fs); }
+
+  span<float> operator()(span<float> out, float a, float f, float pm = 0) {
+    double phs = ph;
+    process([&]() { return synth(a, f, phs, tab, pm); }, out);
+    ph = phs;
+    return out;
+  }
+
+  span<float> operator()(span<float> out, float a, span<const float> fm,
+                         float pm = 0) {
+    double phs = ph;
+    std::size_t n = 0;
+    out = process([&]() { return synth(a, fm[n++], phs, tab, pm); },
+                  out.first(fm.size()));
+    ph = phs;
+    return out;
+  }
+
+  span<float> operator()(span<float> out, span<const float> am, float f,
+                         float pm = 0) {
+    double phs = ph;
+    std::size_t n = 0;
+    out = process([&]() { return synth(am[n++], f, phs, tab, pm); },
+                  out.first(am.size()));
+    ph = phs;
+    return out;
+  }
+
+  span<float> operator()(span<float> out, span<const float> am,
+                         span<const float> fm, float pm = 0) {
+    double phs = ph;
+    std::size_t n = 0;
+    out = process(
+        [&]() {
+          auto s = synth(am[n], fm[n], phs, tab, pm);
+          n++;
+          return s;
+        },
+        out.first(am.size() < fm.size() ? am.size() : fm.size()));
+    ph = phs;
+    return out;
+  }
+
+  span<float> operator()(span<float> out, float a, float f,
+                         span<const float> pm) {
+    double phs = ph;
+    std::size_t n = 0;
+    out = process([&]() { return synth(a, f, phs, tab, pm[n++]); },
+                  out.first(pm.size()));
+    ph = phs;
+    return out;
+  }
+
+  span<float> operator()(span<float> out, span<const float> am, float f,
+                         span<const float> pm) {
+    double phs = ph;
+    std::size_t n = 0;
+    out = process(
+        [&]() {
+          auto s = synth(am[n], f, phs, tab, pm[n]);
+          n++;
+          return s;
+        },
+        out.first(am.size() < pm.size() ? am.size() : pm.size()));
+    ph = phs;
+    return out;
+  }
+};
+
+/* reference BlOsc: overrides synth() only to pick the table */
+class VirtBlOsc : public VirtOsc<Table<float>, lookupi<float>> {
+  const TableSet<float> *tset;
+  float ff;
+
+  float synth(float a, float f, double &phs, const Table<float> *t,
+              float pm) override {
+    if (ff != f || !tab) {
+      tab = &tset->func(f);
+      ff = f;
+    }
+    return step(a, f, phs, tab, pm);
+  }
+
+  void reset_obj(float fs) override {
+    tab = nullptr;
+    VirtOsc::reset_obj(fs);
+  }
+
+public:
+  VirtBlOsc(const TableSet<float> *t) : VirtOsc(nullptr), tset(t), ff(0) {}
+};
+
+/* median times of f and g in ns/sample, over nine runs interleaved
+   so that both see the same machine state */
+template <typename F, typename G>
+std::pair<double, double> nsps(F f, G g, std::size_t vsize,
+                               std::size_t blocks) {
+  const int runs = 9;
+  double tf[runs], tg[runs];
+  auto time = [&](auto &h) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      h();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+           (vsize * blocks);
+  };
+  for (int r = 0; r < runs; r++) {
+    tf[r] = time(f);
+    tg[r] = time(g);
+  }
+  std::nth_element(tf, tf + runs / 2, tf + runs);
+  std::nth_element(tg, tg + runs / 2, tg + runs);
+  return {tf[runs / 2], tg[runs / 2]};
+}
+
+/* runs overload k of oscillator O with constant parameters (as
+   signals where the overload takes them) */
+template <typename O>
+span<float> run(O &osc, int k, span<float> o, const std::vector<float> &am,
+                const std::vector<float> &fm, const std::vector<float> &pm) {
+  const float a = am[0], f = fm[0];
+  switch (k) {
+  case 0:
+    return osc(o, a, f);
+  case 1:
+    return osc(o, a, span<const float>(fm));
+  case 2:
+    return osc(o, span<const float>(am), f);
+  case 3:
+    return osc(o, span<const float>(am), span<const float>(fm));
+  case 4:
+    return osc(o, a, f, span<const float>(pm));
+  default:
+    return osc(o, span<const float>(am), f, span<const float>(pm));
+  }
+}
+
+/* runs the six processing overloads of oscillator O and of its
+   virtual-dispatch reference R, checks that they all produce the
+   same output and prints the times of both */
+template <typename O, typename R>
+bool bench(const char *name, O &osc, R &ref, std::size_t vsize,
+           std::size_t blocks) {
+  std::vector<float> am(vsize, 0.5), fm(vsize, 441), pm(vsize, 0);
+  std::vector<float> out(vsize), buf(vsize * 4), first;
+  const char *args[] = {"a, f", "a, fm", "am, f", "am, fm", "a, f, pm",
+                        "am, f, pm"};
+  bool ok = true;
+  for (int k = 0; k < 12 && ok; k++) {
+    for (int b = 0; b < 4; b++) {
+      span<float> o(buf.data() + b * vsize, vsize);
+      if (b == 0)
+        k < 6 ? osc.reset(def_sr) : ref.reset(def_sr);
+      k < 6 ? run(osc, k, o, am, fm, pm) : run(ref, k - 6, o, am, fm, pm);
+    }
+    if (k == 0)
+      first = buf;
+    else if (first != buf)
+      ok = false;
+  }
+  if (!ok) {
+    std::cout << name << ": error: overloads mismatch" << std::endl;
+    return false;
+  }
+  volatile float sink = 0;
+  std::cout << name;
+  for (int k = 0; k < 6; k++) {
+    span<float> o(out);
+    auto t = nsps([&]() { sink = run(osc, k, o, am, fm, pm)[0]; },
+                  [&]() { sink = run(ref, k, o, am, fm, pm)[0]; }, vsize,
+                  blocks);
+    std::cout << "\t(" << args[k] << "): " << t.first << " / " << t.second;
+  }
+  (void)sink;
+  std::cout << std::endl;
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  bool ok = true;
+  std::vector<float> tab(def_ftlen);
+  for (std::size_t n = 0; n < tab.size(); n++)
+    tab[n] = std::sin(twopi * n / def_ftlen);
+  TableSet<float> saw(SAW);
+  Osc<float> cosc;
+  Osc<float, lookupi> iosc(&tab);
+  Osc<float, lookupc> cuosc(&tab);
+  BlOsc<float> bosc(&saw);
+  VirtOsc<std::vector<float>, cos<float>> rcosc(nullptr);
+  VirtOsc<std::vector<float>, lookupi<float>> riosc(&tab);
+  VirtOsc<std::vector<float>, lookupc<float>> rcuosc(&tab);
+  VirtBlOsc rbosc(&saw);
+  std::cout << "oscillators, vsize = " << vsize << std::endl;
+  std::cout << "(ns/sample, median of 9 interleaved runs: OscBase / "
+               "virtual synth reference)"
+            << std::endl;
+  ok = bench("Osc cos", cosc, rcosc, vsize, blocks) && ok;
+  ok = bench("Osc lookupi", iosc, riosc, vsize, blocks) && ok;
+  ok = bench("Osc lookupc", cuosc, rcuosc, vsize, blocks) && ok;
+  ok = bench("BlOsc", bosc, rbosc, vsize, blocks) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+// oscbank.cpp
+// oscillator bank benchmark
+// N Osc objects vs one OscBank
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+template <typename S, S (*FN)(double, const std::vector<S> *)>
+bool bench(const char *name, std::size_t nos, std::size_t vsize,
+           std::size_t blocks) {
+  std::vector<S> tab(def_ftlen + 1);
+  for (std::size_t n = 0; n < tab.size(); n++)
+    tab[n] = std::sin(twopi * n / def_ftlen);
+  std::vector<Osc<S, FN>> oscs(nos, Osc<S, FN>(&tab, def_sr, vsize));
+  OscBank<S, FN> bank(&tab, nos, def_sr, vsize), check(&tab, nos);
+  std::vector<S> a(nos), f(nos), mix(vsize), parts(nos * vsize);
+  for (std::size_t k = 0; k < nos; k++) {
+    a[k] = 1. / (k + 1);
+    f[k] = 55. * (k + 1) * (1 + 0.001 * k);
+    while (f[k] >= def_sr / 2)
+      f[k] -= def_sr / 2;
+  }
+  bank.params(a, f);
+  check.params(a, f);
+
+  // each bank oscillator matches a single Osc
+  for (int b = 0; b < 4; b++) {
+    check.partials(span<S>(parts), vsize);
+    for (std::size_t k = 0; k < nos; k++) {
+      auto &o = oscs[k](a[k], f[k]);
+      if (std::memcmp(o.data(), parts.data() + k * vsize, vsize * sizeof(S))) {
+        std::cout << name << ": mismatch" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  volatile S sink = 0;
+  double t1 = nsps(
+      [&]() {
+        std::fill(mix.begin(), mix.end(), 0);
+        for (std::size_t k = 0; k < nos; k++) {
+          auto &o = oscs[k](a[k], f[k]);
+          for (std::size_t n = 0; n < vsize; n++)
+            mix[n] += o[n];
+        }
+        sink = mix[0];
+      },
+      vsize * nos, blocks);
+  double t2 = nsps([&]() { sink = bank()[0]; }, vsize * nos, blocks);
+  (void)sink;
+  std::cout << name << t1 << " ns -> " << t2 << " ns per oscillator sample (x"
+            << t1 / t2 << "), " << (std::size_t)(1e9 / (t2 * def_sr))
+            << " oscillators per core at " << def_sr << " Hz" << std::endl;
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t nos = argc > 1 ? std::atoi(argv[1]) : 256;
+  std::size_t vsize = argc > 2 ? std::atoi(argv[2]) : def_vsize;
+  std::size_t blocks = argc > 3 ? std::atoi(argv[3]) : 200;
+  bool ok = true;
+  std::cout << nos << " oscillators, vsize = " << vsize << std::endl;
+  ok = bench<float, sin>("float  sin     ", nos, vsize, blocks) && ok;
+  ok = bench<float, lookupi>("float  lookupi ", nos, vsize, blocks) && ok;
+  ok = bench<float, fsin>("float  fsin    ", nos, vsize, blocks) && ok;
+  ok = bench<double, sin>("double sin     ", nos, vsize, blocks) && ok;
+  ok = bench<double, lookupi>("double lookupi ", nos, vsize, blocks) && ok;
+  ok = bench<double, fsin>("double fsin    ", nos, vsize, blocks) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+// oversample.cpp
+// oversampling benchmark
+// nonlinear stages at the base rate, oversampled, and in a 4x graph
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "FFT.h"
+#include "Func.h"
+#include "Osc.h"
+#include "Oversample.h"
+#include "TwoPole.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+inline float nlm(float s, float dr) { return std::tanh(s * dr) / dr; }
+inline float sat(float s) { return std::tanh(3 * s); }
+
+/* the test patch: a sine oscillator into a driven lowpass SVF
+   and a saturator, whose output is low-pass filtered by a
+   linear SVF; the driven SVF and the saturator are the
+   nonlinear section */
+struct Patch {
+  Osc<float> osc;
+  TwoPole<float, nlm> svf;
+  Func<float, sat> drive;
+  TwoPole<float> post;
+  Patch(float sr, float nsr)
+      : osc(sr, 0), svf(nsr, 0), drive(0), post(sr, 0) {}
+
+  span<float> nonlin(span<float> out, span<const float> in) {
+    return drive(out, svf(out, in, 8000, 0.5, 4));
+  }
+};
+
+const std::size_t fftsize = 4096;
+/* 467 bins: no harmonic lands on an alias of another */
+const double f0 = 467 * def_sr / fftsize;
+
+/* alias level: energy outside the harmonics of f0 relative to the
+   total (dB), over the last fftsize samples of s */
+double aliasing(const std::vector<float> &s) {
+  FFT<float> fft(fftsize);
+  std::vector<float> x(s.end() - fftsize, s.end());
+  auto sp = fft.transform(x);
+  double sig = 0, al = 0;
+  for (std::size_t k = 1; k < fftsize / 2; k++) {
+    double e = std::norm(sp[k]);
+    if (k % 467 == 0)
+      sig += e;
+    else
+      al += e;
+  }
+  return 10 * std::log10(al / (sig + al));
+}
+
+/* runs fn(out) over blocks, returning the output and setting
+   the best of five runs in ns/sample */
+template <typename F>
+std::vector<float> run(F fn, std::size_t vsize, int blocks, double &ns) {
+  std::vector<float> res, out(vsize);
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++) {
+      fn(span<float>(out));
+      if (r == 0)
+        res.insert(res.end(), out.begin(), out.end());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    t /= (double)blocks * vsize;
+    if (r == 0 || t < ns)
+      ns = t;
+  }
+  return res;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  int blocks = argc > 2 ? std::atoi(argv[2]) : 2000;
+  if (vsize < 1)
+    vsize = 1;
+  if (blocks * vsize < 2 * fftsize)
+    blocks = 2 * fftsize / vsize + 1;
+  const float sr = def_sr;
+  double ns;
+  std::vector<float> sig(vsize), hi(4 * vsize), hi2(4 * vsize),
+      lo2(2 * vsize);
+
+  std::cout << "oversampling, vsize = " << vsize << std::endl;
+  std::cout << "method\t\t\tns/sample\taliasing(dB)" << std::endl;
+
+  /* everything at the base rate */
+  Patch base(sr, sr);
+  auto out = run(
+      [&](span<float> o) {
+        auto s = base.osc(span<float>(sig), 0.5f, f0);
+        base.post(o, base.nonlin(span<float>(sig), s), 10000, 1.4);
+      },
+      vsize, blocks, ns);
+  double ab = aliasing(out);
+  std::cout << "base rate\t\t" << ns << "\t\t" << ab << std::endl;
+
+  /* the nonlinear section oversampled, 2x, 4x and 8x */
+  Patch p2(sr, 2 * sr), p4(sr, 4 * sr), p8(sr, 8 * sr);
+  Oversample<float, 2> os2(vsize);
+  Oversample<float, 4> os4(vsize);
+  Oversample<float, 8> os8(vsize);
+  auto nl = [](Patch &p) {
+    return [&p](span<float> o, span<const float> i) { return p.nonlin(o, i); };
+  };
+  out = run(
+      [&](span<float> o) {
+        auto s = p2.osc(span<float>(sig), 0.5f, f0);
+        p2.post(o, os2(span<float>(sig), s, nl(p2)), 10000, 1.4);
+      },
+      vsize, blocks, ns);
+  double a2 = aliasing(out);
+  std::cout << "Oversample<2>\t\t" << ns << "\t\t" << a2 << std::endl;
+  out = run(
+      [&](span<float> o) {
+        auto s = p4.osc(span<float>(sig), 0.5f, f0);
+        p4.post(o, os4(span<float>(sig), s, nl(p4)), 10000, 1.4);
+      },
+      vsize, blocks, ns);
+  double a4 = aliasing(out);
+  std::cout << "Oversample<4>\t\t" << ns << "\t\t" << a4 << std::endl;
+  out = run(
+      [&](span<float> o) {
+        auto s = p8.osc(span<float>(sig), 0.5f, f0);
+        p8.post(o, os8(span<float>(sig), s, nl(p8)), 10000, 1.4);
+      },
+      vsize, blocks, ns);
+  std::cout << "Oversample<8>\t\t" << ns << "\t\t" << aliasing(out)
+            << std::endl;
+
+  /* the cost of the up/down cascade alone */
+  run(
+      [&](span<float> o) {
+        auto s = p4.osc(span<float>(sig), 0.5f, f0);
+        os4(o, s, [](span<float> o, span<const float> i) {
+          std::copy(i.begin(), i.end(), o.begin());
+          return o;
+        });
+      },
+      vsize, blocks, ns);
+  std::cout << "(4x up/down only)\t" << ns << std::endl;
+
+  /* the whole graph at 4x, decimated at the end by the same
+     halfband stages */
+  Patch full(4 * sr, 4 * sr);
+  Halfband<float> d1(12, 7., false, vsize), d2(4, 7., false, 2 * vsize);
+  out = run(
+      [&](span<float> o) {
+        auto s = full.osc(span<float>(hi), 0.5f, f0);
+        auto y = full.post(span<float>(hi2), full.nonlin(span<float>(hi), s),
+                           10000, 1.4);
+        d2.down(y, lo2.data());
+        d1.down(lo2, o.data());
+      },
+      vsize, blocks, ns);
+  double af = aliasing(out);
+  std::cout << "4x graph\t\t" << ns << "\t\t" << af << std::endl;
+
+  /* oversampling has to reduce aliasing, and the 4x wrapper
+     should come close to the 4x graph (which also filters the
+     harmonics at the higher rate, before decimation) */
+  bool ok = a2 < ab - 10 && a4 < a2 - 10 && a4 < af + 15;
+  if (!ok)
+    std::cout << "error: unexpected aliasing levels" << std::endl;
+  return ok ? 0 : 1;
+}
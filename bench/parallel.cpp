@@ -0,0 +1,140 @@
+// parallel.cpp
+// parallel graph executor benchmark
+// serial graph vs work-stealing executor
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Executor.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+/* a bank of independent voices (oscillator -> lowpass filter
+   -> lowpass filter), summed by a chain of adders
+*/
+template <typename S> struct Voices {
+  std::vector<Osc<S>> osc;
+  std::vector<OnePole<S>> fil1, fil2;
+  std::vector<BinOp<S, plus>> add;
+  std::vector<S> fr;
+
+  Voices(std::size_t voices)
+      : osc(voices, Osc<S>(def_sr, 0)), fil1(voices, OnePole<S>(def_sr, 0)),
+        fil2(voices, OnePole<S>(def_sr, 0)), add(voices, BinOp<S, plus>(0)),
+        fr(voices) {
+    for (std::size_t n = 0; n < voices; n++)
+      fr[n] = 100 + 37 * n;
+  }
+
+  void patch(Graph<S> &g) {
+    typename Graph<S>::Port p;
+    for (std::size_t n = 0; n < osc.size(); n++) {
+      g.uses(osc[n]);
+      g.uses(fil1[n]);
+      g.uses(fil2[n]);
+      g.uses(add[n]);
+      auto o = g.node(
+          [this, n](span<S> out) { return osc[n](out, 0.01, fr[n]); });
+      auto f = g.node(
+          [this, n](span<S> out, span<const S> in) {
+            return fil2[n](out, fil1[n](out, in, 1000), 2000);
+          },
+          o);
+      p = n == 0 ? f
+                 : g.node(
+                       [this, n](span<S> out, span<const S> a,
+                                 span<const S> b) { return add[n](out, a, b); },
+                       p, f);
+    }
+    g.output(p);
+  }
+};
+
+template <typename S>
+bool bench(const char *type, std::size_t voices, std::size_t threads,
+           std::size_t vsize, std::size_t blocks) {
+  Voices<S> sv(voices), pv(voices);
+  Graph<S> serial(vsize), graph(vsize);
+  sv.patch(serial);
+  pv.patch(graph);
+  Executor<S> exec(graph, threads);
+  if (!serial.compile() || !exec.threads()) {
+    std::cout << type << ": graph compilation failed" << std::endl;
+    return false;
+  }
+  /* with pauses, so that workers also park and get woken up */
+  for (int n = 0; n < 16; n++) {
+    if (n % 4 == 3)
+      std::this_thread::sleep_for(2 * Executor<S>::spin_time);
+    auto &a = serial();
+    auto &b = exec();
+    if (a.size() != b.size() ||
+        std::memcmp(a.data(), b.data(), a.size() * sizeof(S))) {
+      std::cout << type << ": mismatch" << std::endl;
+      return false;
+    }
+  }
+  volatile S sink = 0;
+  double a = nsps([&]() { sink = serial()[0]; }, vsize, blocks);
+  double b = nsps([&]() { sink = exec()[0]; }, vsize, blocks);
+  (void)sink;
+  std::cout << type << " " << serial.size() << " nodes, vsize = " << vsize
+            << ", " << exec.threads() << " threads" << std::endl;
+  std::cout << "  memory: " << serial.footprint() << " bytes -> "
+            << graph.footprint() << " bytes" << std::endl;
+  std::cout << "  time:   " << a << " ns/sample -> " << b << " ns/sample (x"
+            << a / b << ")" << std::endl;
+  return true;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t threads = argc > 1 ? std::atoi(argv[1])
+                                 : std::thread::hardware_concurrency();
+  std::size_t voices = argc > 2 ? std::atoi(argv[2]) : 64;
+  std::size_t vsize = argc > 3 ? std::atoi(argv[3]) : 256;
+  std::size_t blocks = argc > 4 ? std::atoi(argv[4]) : 200;
+  bool ok = bench<float>("float ", voices, threads, vsize, blocks);
+  ok = bench<double>("double", voices, threads, vsize, blocks) && ok;
+  return ok ? 0 : 1;
+}
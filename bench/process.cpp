@@ -0,0 +1,134 @@
+// process.cpp
+// SndBase::process benchmark:
+// type-erased (std::function) vs templated callable
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#include "SndBase.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* Three representative per-sample bodies (gain, one-pole lowpass,
+   fixed delay), each run through the std::function process()
+   (before) and the templated process() (after).
+*/
+template <typename S> class Kernels : public SndBase<S> {
+  using SndBase<S>::process;
+  double d;
+  std::vector<S> del;
+  std::size_t wp;
+
+  S gain(S in, S g) { return in * g; }
+
+  S lowpass(S in) {
+    S y = 0.2 * in + d;
+    d = 0.2 * in + 0.6 * y;
+    return y;
+  }
+
+  S delay(S in) {
+    S s = del[wp];
+    del[wp] = in + s * 0.5;
+    wp = wp < del.size() - 1 ? wp + 1 : 0;
+    return s;
+  }
+
+public:
+  Kernels(std::size_t vsize) : SndBase<S>(vsize), d(0), del(1031), wp(0){};
+
+  template <bool inl>
+  const sig_vector<S> &gain(const std::vector<S> &in, S g) {
+    std::size_t n = 0;
+    auto f = [&]() { return gain(in[n++], g); };
+    const std::function<S()> fn(f);
+    return inl ? process(f, in.size()) : process(fn, in.size());
+  }
+
+  template <bool inl>
+  const sig_vector<S> &lowpass(const std::vector<S> &in) {
+    std::size_t n = 0;
+    auto f = [&]() { return lowpass(in[n++]); };
+    const std::function<S()> fn(f);
+    return inl ? process(f, in.size()) : process(fn, in.size());
+  }
+
+  template <bool inl>
+  const sig_vector<S> &delay(const std::vector<S> &in) {
+    std::size_t n = 0;
+    auto f = [&]() { return delay(in[n++]); };
+    const std::function<S()> fn(f);
+    return inl ? process(f, in.size()) : process(fn, in.size());
+  }
+};
+
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t n = 0; n < blocks; n++)
+    f();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+         (vsize * blocks);
+}
+
+template <typename S> void run(const char *type, std::size_t vsize,
+                               std::size_t blocks) {
+  std::vector<S> in(vsize);
+  for (auto &s : in)
+    s = (S)std::rand() / RAND_MAX - 0.5;
+  Kernels<S> k(vsize);
+  volatile S sink = 0;
+  double b, a;
+
+  b = nsps([&]() { sink = k.template gain<false>(in, 0.5)[0]; }, vsize,
+           blocks);
+  a = nsps([&]() { sink = k.template gain<true>(in, 0.5)[0]; }, vsize,
+           blocks);
+  std::cout << type << " gain    " << b << " ns/sample -> " << a
+            << " ns/sample (x" << b / a << ")" << std::endl;
+
+  b = nsps([&]() { sink = k.template lowpass<false>(in)[0]; }, vsize, blocks);
+  a = nsps([&]() { sink = k.template lowpass<true>(in)[0]; }, vsize, blocks);
+  std::cout << type << " lowpass " << b << " ns/sample -> " << a
+            << " ns/sample (x" << b / a << ")" << std::endl;
+
+  b = nsps([&]() { sink = k.template delay<false>(in)[0]; }, vsize, blocks);
+  a = nsps([&]() { sink = k.template delay<true>(in)[0]; }, vsize, blocks);
+  std::cout << type << " delay   " << b << " ns/sample -> " << a
+            << " ns/sample (x" << b / a << ")" << std::endl;
+  (void)sink;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 100000;
+  std::cout << "std::function -> templated process(), vsize = " << vsize
+            << std::endl;
+  run<float>("float ", vsize, blocks);
+  run<double>("double", vsize, blocks);
+  return 0;
+}
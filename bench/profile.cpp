@@ -0,0 +1,143 @@
+// profile.cpp
+// profiler example
+// per-object timing polled from another thread
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Del.h"
+#include "FourPole.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include "SpecStream.h"
+#include "TwoPole.h"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace Aurora;
+
+#ifndef AURORA_PROFILE
+#error "profile.cpp needs AURORA_PROFILE"
+#endif
+
+/* an oscillator into filters, a delay and a spectral
+   analysis-synthesis pair, mixed */
+struct Patch {
+  std::vector<float> wave, win;
+  Osc<float, lookupi<float>> osc;
+  TwoPole<float> svf;
+  FourPole<float> lp;
+  Del<float> echo;
+  SpecStream<float> anal;
+  SpecSynth<float> synth;
+  Mix<float> mix;
+
+  Patch(std::size_t vsize)
+      : wave(def_ftlen), win(1024), osc(&wave, def_sr, vsize),
+        svf(def_sr, vsize), lp(def_sr, vsize), echo(0.5, def_sr, vsize),
+        anal(win), synth(win, def_hsize, def_sr, vsize), mix(vsize) {
+    std::size_t n = 0;
+    for (auto &s : wave)
+      s = 1. - 2. * n++ / wave.size();
+    n = 0;
+    for (auto &s : win)
+      s = 0.5 - 0.5 * Aurora::cos<float>((double)n++ / win.size());
+  }
+
+  const sig_vector<float> &operator()(float f) {
+    auto &s = lp(svf(osc(0.5, f), 2000, 0.5), 3000, 0.3);
+    return mix(s, echo(s, 0.25, 0.5), synth(anal(s)));
+  }
+};
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  Patch patch(vsize);
+  std::atomic<bool> done(false);
+  std::size_t polls = 0;
+  bool ok = true;
+
+  /* the audio thread runs the patch, and a voice for a while */
+  std::thread audio([&]() {
+    volatile float sink = 0;
+    OnePole<float> *voice = new OnePole<float>(def_sr, vsize);
+    for (std::size_t b = 0; b < blocks; b++) {
+      auto &s = patch(220 + b % 100);
+      if (voice)
+        sink = (*voice)(s, 500)[0];
+      if (voice && b == blocks / 2) {
+        delete voice;
+        voice = nullptr;
+      }
+      sink = s[0];
+    }
+    (void)sink;
+    done = true;
+  });
+
+  /* the poller reads the statistics as they are updated */
+  std::uint64_t last = 0;
+  while (!done) {
+    for (auto &s : prof_report(true)) {
+      if (s.calls && (s.p99 < s.min || s.p99 > s.max || s.mean < s.min ||
+                      s.mean > s.max))
+        ok = false;
+      if (s.name.find("TwoPole") != std::string::npos) {
+        if (s.calls < last)
+          ok = false;
+        last = s.calls;
+      }
+    }
+    polls++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  audio.join();
+
+  std::cout << "vsize = " << vsize << ", " << blocks << " blocks, " << polls
+            << " reports polled while processing" << std::endl
+            << std::endl;
+  prof_print(std::cout, true);
+  std::cout << std::endl;
+  prof_print(std::cout, false);
+
+  /* every object of the patch processed each block once, and
+     the voice for half of them */
+  for (auto &s : prof_report()) {
+    std::uint64_t n = s.name.find("OnePole") != std::string::npos
+                          ? blocks / 2 + 1
+                          : blocks;
+    if (s.calls != n || s.live == (n != blocks)) {
+      std::cout << "error: " << s.name << " has " << s.calls << " calls"
+                << std::endl;
+      ok = false;
+    }
+  }
+  if (!ok)
+    std::cout << "error: inconsistent statistics" << std::endl;
+  return ok ? 0 : 1;
+}
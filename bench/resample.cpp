@@ -0,0 +1,173 @@
+// resample.cpp
+// sample-rate conversion benchmark
+// quality, aliasing and speed of the resampler presets
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Resample.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* a sum of sines at rate sr, from sample offset t0 */
+std::vector<float> tones(std::size_t n, double sr,
+                         const std::vector<double> &fr, double t0 = 0) {
+  std::vector<float> s(n);
+  for (std::size_t i = 0; i < n; i++)
+    for (auto f : fr)
+      s[i] += (float)(0.5 * std::sin(twopi * f * (i + t0) / sr) / fr.size());
+  return s;
+}
+
+/* signal-to-error ratio (dB) of s against ref, leaving out
+   skip samples at each end */
+double snr(const std::vector<float> &s, const std::vector<float> &ref,
+           std::size_t skip) {
+  double sig = 0, err = 0;
+  for (std::size_t i = skip; i + skip < s.size() && i < ref.size(); i++) {
+    sig += ref[i] * ref[i];
+    err += (s[i] - ref[i]) * (s[i] - ref[i]);
+  }
+  return 10 * std::log10(sig / err);
+}
+
+/* streams in through rs in blocks of vsize samples */
+std::vector<float> stream(Resample<float> &rs, const std::vector<float> &in,
+                          std::size_t vsize) {
+  std::vector<float> out;
+  for (std::size_t n = 0; n < in.size(); n += vsize) {
+    std::size_t k = in.size() - n < vsize ? in.size() - n : vsize;
+    auto &o = rs(span<const float>(in.data() + n, k));
+    out.insert(out.end(), o.begin(), o.end());
+  }
+  return out;
+}
+
+/* ns per output sample of converting in, best of five runs */
+double timeit(Resample<float> &rs, const std::vector<float> &in,
+              std::size_t vsize, int blocks) {
+  std::vector<float> out(vsize * 4);
+  double best = 0;
+  volatile float sink = 0;
+  for (int r = 0; r < 5; r++) {
+    std::size_t cnt = 0, p = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++) {
+      auto o = rs(span<float>(out), span<const float>(in.data() + p, vsize));
+      cnt += o.size();
+      sink = o.size() ? o[0] : 0;
+      p = (p + vsize) % (in.size() - vsize);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() / cnt;
+    if (r == 0 || t < best)
+      best = t;
+  }
+  (void)sink;
+  return best;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  int blocks = argc > 2 ? std::atoi(argv[2]) : 5000;
+  if (vsize < 1)
+    vsize = 1;
+  const char *names[] = {"RS_FAST", "RS_MEDIUM", "RS_BEST"};
+  const double r = 48000. / 44100;
+  std::size_t len = 44100;
+  bool ok = true;
+  auto in = tones(len, 44100, {1000, 5000, 15000});
+  auto hi = tones(len, 48000, {23000});
+  std::cout << "resampling, vsize = " << vsize << std::endl;
+  std::cout << "quality\t\ttaps\tSNR(dB)\talias(dB)\tns/sample\t(scalar)"
+            << std::endl;
+  for (int q = RS_FAST; q <= RS_BEST; q++) {
+    Resample<float> up(r, (rs_quality)q, 0, 4 * vsize),
+        down(1 / r, (rs_quality)q, 0, 4 * vsize);
+    std::size_t skip = 2 * up.size();
+
+    /* 44.1 kHz -> 48 kHz against the same tones computed at 48 kHz */
+    auto out = stream(up, in, vsize);
+    auto ref = tones(out.size(), 48000, {1000, 5000, 15000});
+    double s = snr(out, ref, skip);
+
+    /* 48 kHz -> 44.1 kHz of a 23 kHz tone, above the output
+       Nyquist frequency: what is left is aliasing */
+    auto al = stream(down, hi, vsize);
+    double a = 0;
+    for (std::size_t i = skip; i + skip < al.size(); i++)
+      a += al[i] * al[i];
+    a = 10 * std::log10(a / (al.size() - 2 * skip) / (0.5 * 0.5 * 0.5));
+
+    /* streaming in any block size matches offline conversion */
+    up.reset();
+    auto off = up.convert(in);
+    std::vector<float> str;
+    for (std::size_t n = 0, k = 1; n < in.size(); n += k, k = k * 7 % 251) {
+      k = n + k < in.size() ? k : in.size() - n;
+      std::vector<float> o(k * 2 + 2);
+      auto so = up(span<float>(o), span<const float>(in.data() + n, k));
+      str.insert(str.end(), so.begin(), so.end());
+    }
+    for (std::size_t i = 0; i < str.size() && i < off.size(); i++)
+      if (std::fabs(str[i] - off[i]) > 1e-5f) {
+        ok = false;
+        std::cout << "error: stream/offline mismatch at " << i << std::endl;
+        break;
+      }
+
+    double t = timeit(up, in, vsize, blocks);
+    auto isa = simd::isa();
+    simd::isa(SIMD_SCALAR);
+    double ts = timeit(up, in, vsize, blocks);
+    simd::isa(isa);
+    std::cout << names[q] << (q == RS_MEDIUM ? "\t" : "\t\t") << up.size()
+              << "\t" << s << "\t" << a << "\t\t" << t << "\t\t" << ts
+              << std::endl;
+  }
+
+  /* variable ratio: a sweep between 0.5 and 2 produces the number
+     of samples given by the ratios */
+  {
+    Resample<float> vr(1, RS_MEDIUM, 0.5, 4 * vsize);
+    std::vector<float> out(4 * vsize + 1);
+    double expect = 0;
+    std::size_t cnt = 0;
+    for (std::size_t n = 0; n + vsize <= in.size(); n += vsize) {
+      double ra = std::pow(2., std::sin(twopi * n / in.size()));
+      expect += vsize * ra;
+      cnt += vr(span<float>(out), span<const float>(in.data() + n, vsize), ra)
+                 .size();
+    }
+    bool vok = std::fabs(expect - cnt - vr.latency() * 2.) < 2 * vr.latency();
+    std::cout << "variable ratio: " << cnt << " samples (expected about "
+              << (std::size_t)expect << ")" << (vok ? "" : " error")
+              << std::endl;
+    ok = ok && vok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,220 @@
+// rtsafe.cpp
+// real-time safety check
+// processing calls run under the allocation guard
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "BlOsc.h"
+#include "Conv.h"
+#include "Del.h"
+#include "Env.h"
+#include "Eq.h"
+#include "Executor.h"
+#include "Expr.h"
+#include "Fil.h"
+#include "FourPole.h"
+#include "Func.h"
+#include "Noise.h"
+#include "OnePole.h"
+#include "Osc.h"
+#include "Oversample.h"
+#include "Quad.h"
+#include "Resample.h"
+#include "RtGuard.h"
+#include "SpecStream.h"
+#include "SpscBuff.h"
+#include "TwoPole.h"
+#include <iostream>
+
+using namespace Aurora;
+
+std::size_t allocs = 0, limits = 0;
+bool ok = true;
+
+/* runs f for a few blocks of different sizes (the largest beyond
+   the preallocated vsize) under the guard, reporting allocations,
+   and sizes limited to preallocated memory */
+template <typename F> void check(const char *name, F f) {
+  const std::size_t sizes[] = {64, 16, 128, 64, 1};
+  allocs = limits = 0;
+  for (auto vs : sizes) {
+    rt_scope guard;
+    f(vs);
+  }
+  std::cout << (allocs ? "FAIL " : "ok   ") << name;
+  if (allocs)
+    std::cout << ": " << allocs << " allocations";
+  if (limits)
+    std::cout << (allocs ? ", " : ": ") << limits << " sizes limited";
+  std::cout << std::endl;
+  ok = ok && !allocs;
+}
+
+template <typename S> S sat(S a) { return std::tanh(a); }
+
+template <typename S> void run(const char *type) {
+  std::cout << type << std::endl;
+  std::vector<S> in(128, 0.5), tab(def_ftlen, 0.1), win(1024, 1);
+  auto v = [&](std::size_t vs) { return span<const S>(in.data(), vs); };
+  S att = 0.1, dec = 0.1, sus = 0.5;
+
+  Osc<S, lookupi<S>> osc(&tab);
+  check("Osc", [&](std::size_t vs) { osc(v(vs), 440); });
+  OscBank<S, lookupi<S>> bank(&tab, 8);
+  check("OscBank", [&](std::size_t vs) {
+    bank.vsize(vs);
+    bank();
+  });
+  TableSet<S> waves(SAW);
+  BlOsc<S> blosc(&waves);
+  check("BlOsc", [&](std::size_t vs) { blosc(v(vs), 440); });
+  BlepOsc<S> bposc(PULSE);
+  check("BlepOsc", [&](std::size_t vs) {
+    bposc(v(vs), 440);
+    bposc.vsize(vs);
+    bposc.pwm(0.5, 440, v(vs));
+  });
+  Table<S> gtab(tab);
+  FixOsc<S, lookupc<S>> fosc(&gtab);
+  check("FixOsc", [&](std::size_t vs) { fosc(v(vs), 440); });
+  QuadOsc<S> qosc;
+  check("QuadOsc", [&](std::size_t vs) {
+    qosc.vsize(vs);
+    qosc(0.5, 440);
+  });
+  Env<S> env(ads_gen(att, dec, sus), 0.1);
+  check("Env", [&](std::size_t vs) { env(v(vs), true); });
+  Fil<S, lp_cfs<S>, dfII<S>> fil;
+  check("Fil", [&](std::size_t vs) { fil(v(vs), 1000, 0); });
+  OnePole<S> onep;
+  check("OnePole", [&](std::size_t vs) { onep(v(vs), v(vs)); });
+  TwoPole<S> twop;
+  check("TwoPole", [&](std::size_t vs) { twop(v(vs), 100, 1); });
+  FourPole<S> fourp;
+  check("FourPole", [&](std::size_t vs) { fourp(v(vs), 100, 0.1); });
+  Eq<S> eq;
+  check("Eq", [&](std::size_t vs) { eq(v(vs), 1, 1000, 100); });
+  fil.smooth(8);
+  check("Fil (smooth)", [&](std::size_t vs) { fil(v(vs), 1000 + vs, 0); });
+  onep.smooth(8, true);
+  check("OnePole (smooth)", [&](std::size_t vs) { onep(v(vs), 100 + vs); });
+  twop.smooth(8);
+  check("TwoPole (smooth)", [&](std::size_t vs) { twop(v(vs), 100 + vs, 1); });
+  fourp.smooth(8);
+  check("FourPole (smooth)",
+        [&](std::size_t vs) { fourp(v(vs), 100 + vs, 0.1); });
+  eq.smooth(8);
+  check("Eq (smooth)", [&](std::size_t vs) { eq(v(vs), 1, 1000 + vs, 100); });
+  EqN<S, 2> eqn;
+  check("EqN", [&](std::size_t vs) { eqn({v(vs), v(vs)}, 1, 1000, 100); });
+  Del<S> del(S(0.1));
+  Tap<S> tap;
+  check("Del/Tap", [&](std::size_t vs) {
+    del(v(vs), 0.01, 0.5);
+    tap(del, 0.005);
+    del.reset(0.1, def_sr);
+  });
+  DelN<S, 2> deln(S(0.1));
+  check("DelN", [&](std::size_t vs) {
+    deln({v(vs), v(vs)}, 0.01, 0.5);
+    deln.reset(0.1, def_sr);
+  });
+  Func<S, sat<S>> func;
+  check("Func", [&](std::size_t vs) { func(v(vs)); });
+  Noise<S> noise;
+  check("Noise", [&](std::size_t vs) {
+    noise.vsize(vs);
+    noise(1);
+  });
+  BinOp<S, times> binop;
+  check("BinOp", [&](std::size_t vs) { binop(v(vs), v(vs)); });
+  Mix<S> mix;
+  check("Mix", [&](std::size_t vs) {
+    mix(v(vs), v(vs), v(vs));
+    mix(std::array<S, 2>{0.5, 0.25}, channels<S, 2>{v(vs), v(vs)});
+  });
+  Bus<S> bus(2);
+  std::vector<span<const S>> ins(2);
+  std::vector<S> gs(2, 0.5);
+  check("Bus", [&](std::size_t vs) {
+    ins[0] = ins[1] = v(vs);
+    gs[0] = gs[0] == 0.5 ? 1 : 0.5;
+    bus(ins, gs);
+    bus(span<const span<const S>>(ins.data(), 1), gs);
+  });
+  Eval<S> eval;
+  check("Eval", [&](std::size_t vs) {
+    eval(0.5 * (lazy(v(vs)) + lazy(v(vs))));
+  });
+  Buff<S> buff(256);
+  check("Buff", [&](std::size_t vs) {
+    buff(v(vs));
+    buff();
+  });
+  SpscBuff<S> spsc(256);
+  check("SpscBuff", [&](std::size_t vs) {
+    spsc(v(vs));
+    spsc();
+  });
+  IR<S> ir(tab, 256);
+  Conv<S> conv(&ir), tvconv(1024, 256);
+  check("Conv", [&](std::size_t vs) {
+    conv(v(vs), 1);
+    tvconv(v(vs), v(vs), 1);
+    conv.reset(&ir);
+    tvconv.reset(1024, 256);
+  });
+  Quad<S> quad;
+  check("Quad", [&](std::size_t vs) { quad(v(vs)); });
+  Oversample<S, 4> ovs;
+  Func<S, sat> ovf(0);
+  check("Oversample", [&](std::size_t vs) {
+    ovs(v(vs), [&](span<S> o, span<const S> i) { return ovf(o, i); });
+  });
+  Resample<S> rsm(1.5, RS_MEDIUM, 0.5);
+  check("Resample", [&](std::size_t vs) { rsm(v(vs), 0.5 + vs / 128.); });
+  SpecStream<S> anal(win);
+  SpecSynth<S> synth(win);
+  check("SpecStream/SpecSynth", [&](std::size_t vs) { synth(anal(v(vs))); });
+
+  Osc<S> gosc(def_sr, 0);
+  OnePole<S> gfil(def_sr, 0);
+  Graph<S> graph;
+  auto o = graph.node([&](span<S> out) { return gosc(out, 0.5, 440); });
+  graph.output(graph.node(
+      [&](span<S> out, span<const S> x) { return gfil(out, x, 1000); }, o));
+  Executor<S> exec(graph, 2);
+  check("Graph/Executor", [&](std::size_t vs) {
+    (void)vs;
+    exec();
+  });
+}
+
+int main() {
+  rt_alloc_hook = [](std::size_t) { allocs++; };
+  rt_limit_hook = [](std::size_t, std::size_t) { limits++; };
+  run<float>("float");
+  run<double>("double");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+// simd.cpp
+// Vector kernel benchmark and check
+// against the scalar kernels
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+
+#include "Simd.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace Aurora;
+
+const char *names[] = {"scalar", "sse2", "avx2", "avx512"};
+
+template <typename S>
+using kern = std::function<void(const S *, const S *, const S *, S *,
+                                std::size_t)>;
+
+/* special inputs: signed zeros, NaNs, infinities and clipping,
+   rounding and tanh limits
+*/
+template <typename S> std::vector<S> special() {
+  const S nan = std::numeric_limits<S>::quiet_NaN(),
+          inf = std::numeric_limits<S>::infinity();
+  return {-0., 0., nan, -nan, inf, -inf, 1, -1, .5, -.5, 5, -5, 1.5, -2.5};
+}
+
+/* runs one kernel under each instruction set, comparing results
+   with the scalar path (bit-exact expected) and timing them;
+   the special inputs are placed at both ends of the block, so
+   that they go through the vector lanes and the scalar remainder
+*/
+template <typename S>
+bool run(const char *type, const char *name, const kern<S> &k,
+         std::size_t vsize, std::size_t blocks) {
+  std::vector<S> a(vsize), b(vsize), c(vsize), ref(vsize), o(vsize);
+  for (std::size_t n = 0; n < vsize; n++) {
+    a[n] = 8 * ((S)std::rand() / RAND_MAX - 0.5);
+    b[n] = 8 * ((S)std::rand() / RAND_MAX - 0.5);
+    c[n] = 8 * ((S)std::rand() / RAND_MAX - 0.5);
+  }
+  auto sp = special<S>();
+  for (std::size_t n = 0; n < sp.size() && n < vsize; n++) {
+    a[n] = sp[n];
+    a[vsize - 1 - n] = sp[n];
+  }
+  simd_isa top = simd::isa();
+  bool ok = true;
+  simd::isa(SIMD_SCALAR);
+  k(a.data(), b.data(), c.data(), ref.data(), vsize);
+  std::cout << type << " " << name;
+  for (int i = SIMD_SCALAR; i <= top; i++) {
+    simd::isa((simd_isa)i);
+    k(a.data(), b.data(), c.data(), o.data(), vsize);
+    bool same = std::memcmp(o.data(), ref.data(), vsize * sizeof(S)) == 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      k(a.data(), b.data(), c.data(), o.data(), vsize);
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << "  " << names[i] << ": "
+              << std::chrono::duration<double, std::nano>(t1 - t0).count() /
+                     (vsize * blocks)
+              << " ns/sample" << (same ? "" : " MISMATCH");
+    ok = ok && same;
+  }
+  std::cout << std::endl;
+  simd::isa(top);
+  return ok;
+}
+
+template <typename S>
+bool run_all(const char *type, std::size_t vsize, std::size_t blocks) {
+  bool ok = true;
+  ok &= run<S>(type, "add     ",
+               [](const S *a, const S *b, const S *, S *o, std::size_t n) {
+                 simd::add(a, b, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "adds    ",
+               [](const S *a, const S *b, const S *, S *o, std::size_t n) {
+                 simd::add(a, b[0], o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "mul     ",
+               [](const S *a, const S *b, const S *, S *o, std::size_t n) {
+                 simd::mul(a, b, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "muls    ",
+               [](const S *a, const S *b, const S *, S *o, std::size_t n) {
+                 simd::mul(a, b[0], o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "muladd  ",
+               [](const S *a, const S *b, const S *c, S *o, std::size_t n) {
+                 simd::muladd(a, b, c, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "muladds ",
+               [](const S *a, const S *b, const S *c, S *o, std::size_t n) {
+                 simd::muladd(a, b[0], c, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "scaloffs",
+               [](const S *a, const S *b, const S *, S *o, std::size_t n) {
+                 simd::scaloffs(a, b[0], b[1], o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "abs     ",
+               [](const S *a, const S *, const S *, S *o, std::size_t n) {
+                 simd::abs(a, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "clip    ",
+               [](const S *a, const S *, const S *, S *o, std::size_t n) {
+                 simd::clip(a, (S)-1, (S)1, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "tanh    ",
+               [](const S *a, const S *, const S *, S *o, std::size_t n) {
+                 simd::tanh(a, o, n);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "peak    ",
+               [](const S *a, const S *, const S *, S *o, std::size_t n) {
+                 // whole block (with NaNs) and the middle (without)
+                 o[0] = simd::peak(a, n);
+                 o[1] = simd::peak(a + 16, n > 32 ? n - 32 : 0);
+               },
+               vsize, blocks);
+  ok &= run<S>(type, "sin2pi  ",
+               [](const S *a, const S *, const S *, S *o, std::size_t n) {
+                 simd::sin2pi(a, o, n);
+               },
+               vsize, blocks);
+  return ok;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : 67;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 100000;
+  std::cout << "vector kernels, vsize = " << vsize
+            << ", detected: " << names[simd::isa()] << std::endl;
+  bool ok = run_all<float>("float ", vsize, blocks);
+  ok &= run_all<double>("double", vsize, blocks);
+  std::cout << (ok ? "all kernels match the scalar path"
+                   : "kernel results differ from the scalar path")
+            << std::endl;
+  return ok ? 0 : 1;
+}
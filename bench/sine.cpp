@@ -0,0 +1,163 @@
+// sine.cpp
+// sinusoid benchmark
+// accuracy and speed of the fast sine and quadrature oscillators
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Func.h"
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* best of five runs, to filter out scheduling noise */
+template <typename F> double nsps(F f, std::size_t vsize, std::size_t blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t n = 0; n < blocks; n++)
+      f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() /
+               (vsize * blocks);
+    best = r == 0 || t < best ? t : best;
+  }
+  return best;
+}
+
+/* max abs error of sinpoly over a grid of phases in [-1, 2) */
+template <typename S> double sinerr(sin_quality q) {
+  double err = 0;
+  for (long i = -1000000; i < 2000000; i++) {
+    S x = (S)(i / 1e6);
+    double e = std::fabs(sinpoly(x, q) - std::sin(twopi * (double)x));
+    err = e > err ? e : err;
+  }
+  return err;
+}
+
+/* Osc with function FN, time per sample */
+template <float (*FN)(double, const std::vector<float> *)>
+double osc(std::size_t vsize, std::size_t blocks) {
+  Osc<float, FN> o(def_sr, vsize);
+  volatile float sink = 0;
+  double t = nsps([&]() { sink = o(0.5, 441.)[0]; }, vsize, blocks);
+  (void)sink;
+  return t;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  std::size_t blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  bool ok = true;
+  const char *names[] = {"SIN_FAST", "SIN_MEDIUM", "SIN_BEST"};
+  const double lim[2][3] = {{7e-5, 8e-7, 2.5e-7}, {7e-5, 6e-7, 1.5e-11}};
+  std::cout << "sinpoly max error\tfloat\t\tdouble" << std::endl;
+  for (int q = SIN_FAST; q <= SIN_BEST; q++) {
+    double ef = sinerr<float>((sin_quality)q),
+           ed = sinerr<double>((sin_quality)q);
+    std::cout << names[q] << (q == SIN_MEDIUM ? "\t\t" : "\t\t\t") << ef
+              << "\t" << ed << std::endl;
+    if (ef > lim[0][q] || ed > lim[1][q]) {
+      std::cout << "error: " << names[q] << " above its bound" << std::endl;
+      ok = false;
+    }
+  }
+
+  /* ten minutes of a 441 Hz sinusoid, against its exact phase
+     (a whole number of cycles every 100 samples) */
+  {
+    QuadOsc<double> qo(def_sr, vsize);
+    std::vector<double> s(vsize), c(vsize);
+    std::size_t len = 600 * def_sr, n = 0;
+    double err = 0;
+    while (n < len) {
+      qo(span<double>(s), span<double>(c), 1., 441.);
+      for (std::size_t i = 0; i < vsize; i++, n++) {
+        double ph = twopi * ((n * 441) % (std::size_t)def_sr) / def_sr;
+        double e =
+            std::fabs(s[i] - std::sin(ph)) + std::fabs(c[i] - std::cos(ph));
+        err = e > err ? e : err;
+      }
+    }
+    std::cout << "QuadOsc max error over ten minutes: " << err << std::endl;
+    if (err > 1e-13) {
+      std::cout << "error: QuadOsc above its bound" << std::endl;
+      ok = false;
+    }
+  }
+
+  std::cout << "ns/sample, vsize = " << vsize << std::endl;
+  std::cout << "Osc cos\t\t\t" << osc<cos>(vsize, blocks) << std::endl;
+  std::cout << "Osc fcos SIN_FAST\t"
+            << osc<fcos<float, SIN_FAST>>(vsize, blocks) << std::endl;
+  std::cout << "Osc fcos SIN_MEDIUM\t"
+            << osc<fcos<float, SIN_MEDIUM>>(vsize, blocks) << std::endl;
+  std::cout << "Osc fcos SIN_BEST\t"
+            << osc<fcos<float, SIN_BEST>>(vsize, blocks) << std::endl;
+  {
+    QuadOsc<float> qo(def_sr, vsize);
+    volatile float sink = 0;
+    std::cout << "QuadOsc\t\t\t"
+              << nsps([&]() { sink = qo(0.5, 441.)[0]; }, vsize, blocks)
+              << std::endl;
+    (void)sink;
+  }
+  {
+    std::vector<float> ph(vsize);
+    for (std::size_t i = 0; i < vsize; i++)
+      ph[i] = (float)i / vsize;
+    Func<float, cosn> fc(vsize);
+    Func<float, fcosn> ffc(vsize);
+    volatile float sink = 0;
+    std::cout << "Func cosn\t\t"
+              << nsps([&]() { sink = fc(ph)[0]; }, vsize, blocks) << std::endl;
+    std::cout << "Func fcosn\t\t"
+              << nsps([&]() { sink = ffc(ph)[0]; }, vsize, blocks)
+              << std::endl;
+    (void)sink;
+  }
+  {
+    const std::size_t nos = 64;
+    OscBank<float, cos> bc(nos, def_sr, vsize);
+    OscBank<float, fcos> bf(nos, def_sr, vsize);
+    for (std::size_t k = 0; k < nos; k++) {
+      bc.amp(k, 1. / nos), bf.amp(k, 1. / nos);
+      bc.freq(k, 100. * (k + 1)), bf.freq(k, 100. * (k + 1));
+    }
+    volatile float sink = 0;
+    std::cout << "OscBank cos (64)\t"
+              << nsps([&]() { sink = bc()[0]; }, vsize * nos, blocks / 16)
+              << std::endl;
+    std::cout << "OscBank fcos (64)\t"
+              << nsps([&]() { sink = bf()[0]; }, vsize * nos, blocks / 16)
+              << std::endl;
+    (void)sink;
+  }
+  return ok ? 0 : 1;
+}
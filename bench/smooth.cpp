@@ -0,0 +1,177 @@
+// smooth.cpp
+// parameter smoothing benchmark
+// jumps vs control-rate ramps vs audio-rate parameters
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Eq.h"
+#include "Fil.h"
+#include "FourPole.h"
+#include "OnePole.h"
+#include "TwoPole.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* cutoff sequence: a new value every block, sweeping up and
+   down between 200 Hz and 5 kHz */
+inline float cutoff(std::size_t b) {
+  double t = (b % 64) / 32.;
+  return (float)(200 * std::pow(25., t < 1 ? t : 2 - t));
+}
+
+/* the cutoff ramp of block b, per sample */
+void ramp(std::vector<float> &f, std::size_t b, const Smooth<float> &sm) {
+  float f0 = cutoff(b ? b - 1 : 0), f1 = cutoff(b);
+  std::size_t n = f.size();
+  for (std::size_t i = 0; i < n; i++)
+    f[i] = b ? sm.at(f0, f1, (double)(i + 1) / n) : f1;
+}
+
+/* runs fn(block) over blocks, returning the best of five
+   runs in ns/sample */
+template <typename F> double timeit(F fn, std::size_t vsize, int blocks) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++)
+      fn(b);
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    t /= (double)blocks * vsize;
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+/* a filter under test: F(fil, out, in, f) runs a block with
+   scalar cutoff f, V(fil, out, in, fv) with cutoff signal fv */
+template <typename FIL, typename F, typename V>
+bool bench(const char *name, std::size_t vsize, int blocks, F scalar,
+           V audio) {
+  std::vector<float> in(vsize), out(vsize), ref(vsize), fv(vsize);
+  span<float> so(out);
+  Smooth<float> sm;
+  sm.rate(1, true);
+  for (std::size_t n = 0; n < vsize; n++)
+    in[n] = (float)std::rand() / RAND_MAX - 0.5f;
+
+  /* a ramp with coefficients computed every sample matches the
+     filter run one sample at a time along the same ramp (to within
+     rounding, as the compiled code differs) */
+  bool ok = true;
+  {
+    FIL a, b;
+    a.smooth(1, true);
+    for (int k = 0; k < 64 && ok; k++) {
+      ramp(fv, k, sm);
+      scalar(a, so, in, cutoff(k));
+      for (std::size_t n = 0; n < vsize; n++)
+        scalar(b, span<float>(ref.data() + n, 1), span<const float>(&in[n], 1),
+               fv[n]);
+      for (std::size_t n = 0; n < vsize; n++)
+        if (std::fabs(out[n] - ref[n]) > 1e-4f)
+          ok = false;
+    }
+  }
+
+  FIL a, b, c, d;
+  b.smooth(32, true);
+  c.smooth(8, true);
+  volatile float sink = 0;
+  double tj = timeit(
+      [&](int k) { sink = scalar(a, so, in, cutoff(k))[0]; }, vsize, blocks);
+  double ts = timeit(
+      [&](int k) { sink = scalar(b, so, in, cutoff(k))[0]; }, vsize, blocks);
+  double t8 = timeit(
+      [&](int k) { sink = scalar(c, so, in, cutoff(k))[0]; }, vsize, blocks);
+  double ta = timeit(
+      [&](int k) {
+        ramp(fv, k, sm);
+        sink = audio(d, so, in, fv)[0];
+      },
+      vsize, blocks);
+  (void)sink;
+  std::cout << name << "\t" << tj << "\t" << ts << "\t" << t8 << "\t" << ta
+            << (ok ? "" : "\t(error: ramp mismatch)") << std::endl;
+  return ok;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  int blocks = argc > 2 ? std::atoi(argv[2]) : 10000;
+  if (vsize < 1)
+    vsize = 1;
+  using fspan = span<float>;
+  using cspan = span<const float>;
+  bool ok = true;
+  std::cout << "parameter smoothing, vsize = " << vsize << " (ns/sample)"
+            << std::endl;
+  std::cout << "filter\t\tjump\tk=32\tk=8\taudio-rate" << std::endl;
+  ok = bench<OnePole<float>>(
+           "OnePole\t", vsize, blocks,
+           [](auto &f, fspan o, cspan i, float c) { return f(o, i, c); },
+           [](auto &f, fspan o, cspan i, cspan c) { return f(o, i, c); }) &&
+       ok;
+  ok = bench<TwoPole<float>>(
+           "TwoPole\t", vsize, blocks,
+           [](auto &f, fspan o, cspan i, float c) { return f(o, i, c, 0.5f); },
+           [](auto &f, fspan o, cspan i, cspan c) {
+             return f(o, i, c, 0.5f);
+           }) &&
+       ok;
+  ok = bench<FourPole<float>>(
+           "FourPole", vsize, blocks,
+           [](auto &f, fspan o, cspan i, float c) { return f(o, i, c, 0.5f); },
+           [](auto &f, fspan o, cspan i, cspan c) {
+             return f(o, i, c, 0.5f);
+           }) &&
+       ok;
+  ok = bench<Fil<float, reson_cfs1, reson>>(
+           "Reson\t", vsize, blocks,
+           [](auto &f, fspan o, cspan i, float c) { return f(o, i, c, 50.f); },
+           [](auto &f, fspan o, cspan i, cspan c) {
+             return f(o, i, c, 50.f);
+           }) &&
+       ok;
+  /* Eq has no audio-rate form: it is run one sample at a time */
+  ok = bench<Eq<float>>(
+           "Eq\t", vsize, blocks,
+           [](auto &f, fspan o, cspan i, float c) {
+             return f(o, i, 2.f, c, c * 0.5f);
+           },
+           [](auto &f, fspan o, cspan i, cspan c) {
+             auto r = o.first(i.size());
+             for (std::size_t n = 0; n < r.size(); n++)
+               f(fspan(r.data() + n, 1), cspan(i.data() + n, 1), 2.f, c[n],
+                 c[n] * 0.5f);
+             return r;
+           }) &&
+       ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+// sndfile.h:
+// in-memory soundfile interface
+// libsndfile subset used by the golden-output harness
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_SNDFILE_SHIM_
+#define _AURORA_SNDFILE_SHIM_
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/* This header replaces libsndfile for the examples built into the
+   golden harness. Soundfiles are held in memory as raw floats,
+   keyed by file name, so that the harness can supply the inputs of
+   the examples and collect their outputs without any file I/O.
+*/
+
+typedef int64_t sf_count_t;
+
+struct SF_INFO {
+  sf_count_t frames;
+  int samplerate;
+  int channels;
+  int format;
+  int sections;
+  int seekable;
+};
+
+enum { SFM_READ = 0x10, SFM_WRITE = 0x20 };
+enum { SF_FORMAT_WAV = 0x010000, SF_FORMAT_FLOAT = 0x0006 };
+
+/** in-memory soundfile */
+struct sf_file {
+  std::vector<float> data;
+  int samplerate = 44100;
+  int channels = 1;
+};
+
+/** soundfile store, keyed by file name */
+inline std::map<std::string, sf_file> &sf_files() {
+  static std::map<std::string, sf_file> files;
+  return files;
+}
+
+struct SNDFILE {
+  sf_file *file;
+  std::size_t pos;
+};
+
+inline SNDFILE *sf_open(const char *path, int mode, SF_INFO *info) {
+  auto &files = sf_files();
+  if (mode == SFM_READ) {
+    auto it = files.find(path);
+    if (it == files.end())
+      return nullptr;
+    sf_file &f = it->second;
+    info->channels = f.channels;
+    info->samplerate = f.samplerate;
+    info->frames = f.data.size() / f.channels;
+    info->format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    info->sections = 1;
+    info->seekable = 1;
+    return new SNDFILE{&f, 0};
+  } else if (mode == SFM_WRITE) {
+    sf_file &f = files[path];
+    f.data.clear();
+    f.samplerate = info->samplerate;
+    f.channels = info->channels > 0 ? info->channels : 1;
+    return new SNDFILE{&f, 0};
+  }
+  return nullptr;
+}
+
+inline int sf_close(SNDFILE *sf) {
+  delete sf;
+  return 0;
+}
+
+template <typename T>
+inline sf_count_t sf_read_items(SNDFILE *sf, T *ptr, sf_count_t items) {
+  auto &d = sf->file->data;
+  std::size_t n = std::min((std::size_t)items, d.size() - sf->pos);
+  std::copy(d.begin() + sf->pos, d.begin() + sf->pos + n, ptr);
+  sf->pos += n;
+  return n;
+}
+
+template <typename T>
+inline sf_count_t sf_write_items(SNDFILE *sf, const T *ptr, sf_count_t items) {
+  sf->file->data.insert(sf->file->data.end(), ptr, ptr + items);
+  return items;
+}
+
+inline sf_count_t sf_read_float(SNDFILE *sf, float *ptr, sf_count_t items) {
+  return sf_read_items(sf, ptr, items);
+}
+
+inline sf_count_t sf_read_double(SNDFILE *sf, double *ptr, sf_count_t items) {
+  return sf_read_items(sf, ptr, items);
+}
+
+inline sf_count_t sf_write_float(SNDFILE *sf, const float *ptr,
+                                 sf_count_t items) {
+  return sf_write_items(sf, ptr, items);
+}
+
+inline sf_count_t sf_write_double(SNDFILE *sf, const double *ptr,
+                                  sf_count_t items) {
+  return sf_write_items(sf, ptr, items);
+}
+
+inline sf_count_t sf_writef_float(SNDFILE *sf, const float *ptr,
+                                  sf_count_t frames) {
+  return sf_write_items(sf, ptr, frames * sf->file->channels) /
+         sf->file->channels;
+}
+
+#endif // _AURORA_SNDFILE_SHIM_
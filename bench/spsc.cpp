@@ -0,0 +1,183 @@
+// spsc.cpp
+// lock-free circular buffer stress test and benchmark
+// SpscBuff vs Buff guarded by a mutex
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "SpscBuff.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace Aurora;
+
+/* sample values follow a counter, exact in single precision */
+template <typename S> S value(std::size_t n) { return S(n & 0xFFFFF); }
+
+/* block sizes from a small linear congruential generator */
+struct Sizes {
+  std::uint32_t x;
+  std::size_t max;
+  Sizes(std::uint32_t seed, std::size_t m) : x(seed), max(m) {}
+  std::size_t operator()() {
+    x = x * 1664525 + 1013904223;
+    return 1 + (x >> 8) % max;
+  }
+};
+
+/* producer and consumer threads moving a counter sequence of
+   total samples in random block sizes, alternating between copies
+   and direct access to the buffer regions, checking that the
+   consumer receives every sample in order; returns ns/sample
+*/
+template <typename S>
+double stress(std::size_t bsize, std::size_t total, bool &ok) {
+  SpscBuff<S> buf(bsize);
+  auto t0 = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    std::vector<S> blk(bsize);
+    Sizes sz(1, bsize);
+    std::size_t n = 0, k = 0;
+    while (n < total) {
+      std::size_t m = std::min(sz(), total - n);
+      std::size_t w = 0;
+      if (k++ & 1) {
+        for (std::size_t i = 0; i < m; i++)
+          blk[i] = value<S>(n + i);
+        w = buf(span<const S>(blk.data(), m));
+      } else {
+        for (auto &r : buf.write_regions(m))
+          for (auto &s : r)
+            s = value<S>(n + w++);
+        buf.commit(w);
+      }
+      if (w == 0)
+        std::this_thread::yield();
+      n += w;
+    }
+  });
+  std::vector<S> blk(bsize);
+  Sizes sz(2, bsize);
+  std::size_t n = 0, k = 0;
+  ok = true;
+  while (n < total) {
+    std::size_t m = std::min(sz(), total - n);
+    std::size_t r = 0;
+    if (k++ & 1) {
+      auto out = buf(span<S>(blk.data(), m));
+      for (auto s : out)
+        ok = ok && s == value<S>(n + r++);
+    } else {
+      for (auto &reg : buf.read_regions(m))
+        for (auto s : reg)
+          ok = ok && s == value<S>(n + r++);
+      buf.consume(r);
+    }
+    if (r == 0)
+      std::this_thread::yield();
+    n += r;
+  }
+  producer.join();
+  ok = ok && buf.fill() == 0 && buf.space() == bsize;
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / total;
+}
+
+/* the same transfer through a Buff guarded by a mutex, with the
+   fill count kept alongside; returns ns/sample
+*/
+template <typename S>
+double locked(std::size_t bsize, std::size_t total, bool &ok) {
+  Buff<S> buf(bsize, 0);
+  std::mutex mtx;
+  std::size_t cnt = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  std::thread producer([&]() {
+    std::vector<S> blk(bsize);
+    Sizes sz(1, bsize);
+    std::size_t n = 0;
+    while (n < total) {
+      std::size_t m = std::min(sz(), total - n), w;
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        w = std::min(m, bsize - cnt);
+        for (std::size_t i = 0; i < w; i++)
+          blk[i] = value<S>(n + i);
+        buf(span<const S>(blk.data(), w));
+        cnt += w;
+      }
+      if (w == 0)
+        std::this_thread::yield();
+      n += w;
+    }
+  });
+  std::vector<S> blk(bsize);
+  Sizes sz(2, bsize);
+  std::size_t n = 0;
+  ok = true;
+  while (n < total) {
+    std::size_t m = std::min(sz(), total - n), r;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      r = std::min(m, cnt);
+      buf(span<S>(blk.data(), r));
+      cnt -= r;
+    }
+    for (std::size_t i = 0; i < r; i++)
+      ok = ok && blk[i] == value<S>(n + i);
+    if (r == 0)
+      std::this_thread::yield();
+    n += r;
+  }
+  producer.join();
+  auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / total;
+}
+
+template <typename S>
+bool run(const char *name, std::size_t bsize, std::size_t total) {
+  bool ok1, ok2;
+  double t1 = locked<S>(bsize, total, ok1);
+  double t2 = stress<S>(bsize, total, ok2);
+  std::cout << name << ": mutex Buff " << t1 << " ns/sample, SpscBuff " << t2
+            << " ns/sample" << (ok1 && ok2 ? "" : " MISMATCH") << std::endl;
+  return ok1 && ok2;
+}
+
+int main(int argc, const char **argv) {
+  std::size_t bsize = argc > 1 ? std::atoi(argv[1]) : 1024;
+  std::size_t total = argc > 2 ? std::atoi(argv[2]) : 1 << 24;
+  if (bsize < 1)
+    bsize = 1;
+  std::cout << "buffer size " << bsize << ", " << total << " samples"
+            << std::endl;
+  bool ok = run<float>("float", bsize, total);
+  ok = run<double>("double", bsize, total) && ok;
+  return ok ? 0 : 1;
+}
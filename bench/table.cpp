@@ -0,0 +1,148 @@
+// table.cpp
+// guarded table lookup benchmark
+// accuracy and speed of the branch-free and gather lookups
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Osc.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* ns per call of f() over cnt samples, best of five runs */
+template <typename F> double timeit(F f, std::size_t cnt) {
+  double best = 0;
+  for (int r = 0; r < 5; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    double t = std::chrono::duration<double, std::nano>(t1 - t0).count() / cnt;
+    if (r == 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  int blocks = argc > 2 ? std::atoi(argv[2]) : 20000;
+  if (vsize < 1)
+    vsize = 1;
+  const std::size_t len = def_ftlen;
+  bool ok = true;
+  std::vector<float> wave(len);
+  for (std::size_t i = 0; i < len; i++)
+    for (int h = 1; h < 16; h++)
+      wave[i] += (float)(std::sin(twopi * h * i / len) / h);
+  Table<float> tab(wave);
+  if ((std::uintptr_t)tab.data() % def_align) {
+    std::cout << "error: table data not aligned" << std::endl;
+    ok = false;
+  }
+
+  /* reading positions: a phasor sweeping the table, ending on
+     the last position, which wraps around */
+  std::vector<float> pos(vsize * 16), out(pos.size()), ref(pos.size());
+  for (std::size_t i = 0; i < pos.size(); i++)
+    pos[i] = std::fmod(i * 37.3, (double)len);
+  pos.back() = len;
+
+  /* scalar lookups match the existing circular ones */
+  double err[3] = {0, 0, 0};
+  for (auto p : pos) {
+    double e[3] = {tab.linear(p) - linear_interp(p == len ? 0 : p, wave),
+                   tab.cubic(p) - cubic_interp(p == len ? 0 : p, wave),
+                   tab.hermite(p) - tab.cubic(p)};
+    for (int k = 0; k < 3; k++)
+      err[k] = std::fabs(e[k]) > err[k] ? std::fabs(e[k]) : err[k];
+  }
+  std::cout << "table lookups, vsize = " << vsize << std::endl;
+  std::cout << "max error: linear " << err[0] << ", cubic " << err[1]
+            << " (against linear_interp, cubic_interp)"
+            << ", hermite " << err[2] << " (against cubic)" << std::endl;
+  if (err[0] > 0 || err[1] > 1e-5 || err[2] > 1e-3) {
+    std::cout << "error: scalar lookup mismatch" << std::endl;
+    ok = false;
+  }
+
+  /* block lookups, all instruction sets giving the same result */
+  const char *names[] = {"linear", "cubic", "hermite"};
+  const char *isas[] = {"scalar", "sse2", "avx2", "avx512"};
+  auto isa = simd::isa();
+  std::size_t cnt = blocks * vsize;
+  std::cout << "\t\tscalar\tblock" << std::endl;
+  for (int m = 0; m < 3; m++) {
+    auto block = [&](span<float> o, span<const float> p) {
+      return m == 0 ? tab.linear(o, p)
+                    : (m == 1 ? tab.cubic(o, p) : tab.hermite(o, p));
+    };
+    simd::isa(SIMD_SCALAR);
+    block(span<float>(ref), pos);
+    for (int i = SIMD_SSE2; i <= isa; i++) {
+      simd::isa((simd_isa)i);
+      block(span<float>(out), pos);
+      for (std::size_t j = 0; j < out.size(); j++)
+        if (out[j] != ref[j]) {
+          std::cout << "error: " << names[m] << " " << isas[i]
+                    << " mismatch at " << j << std::endl;
+          ok = false;
+          break;
+        }
+    }
+    simd::isa(isa);
+
+    volatile float sink = 0;
+    double ts = timeit(
+        [&]() {
+          for (int b = 0; b < blocks; b++) {
+            const float *p = pos.data() + (b % 16) * vsize;
+            float s = 0;
+            for (std::size_t j = 0; j < vsize; j++)
+              s += m == 0 ? linear_interp(p[j] == len ? 0 : p[j], wave)
+                          : (m == 1 ? cubic_interp(p[j] == len ? 0 : p[j], wave)
+                                    : tab.hermite(p[j]));
+            sink = s;
+          }
+        },
+        cnt);
+    double tb = timeit(
+        [&]() {
+          for (int b = 0; b < blocks; b++) {
+            span<const float> p(pos.data() + (b % 16) * vsize, vsize);
+            sink = block(span<float>(out), p)[0];
+          }
+        },
+        cnt);
+    (void)sink;
+    std::cout << names[m] << "\t\t" << ts << "\t" << tb
+              << std::endl;
+  }
+  std::cout << "(ns/sample; scalar is linear_interp/cubic_interp on a "
+               "std::vector, Table::hermite for hermite; block uses "
+            << isas[isa] << ")" << std::endl;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// tail.cpp
+// decaying tail benchmark
+// denormal flushing and silence-tail detection
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+#include "Del.h"
+#include "FourPole.h"
+#include "Noise.h"
+#include "Quad.h"
+#include "TwoPole.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace Aurora;
+
+/* a burst of noise into a bank of feedback combs, followed
+   by a chain of filters, left to ring out */
+template <typename S> struct Patch {
+  std::vector<Del<S>> combs;
+  TwoPole<S> svf;
+  FourPole<S> lp;
+  Quad<S> quad;
+  std::vector<S> sum;
+
+  Patch(std::size_t vsize)
+      : svf(def_sr, vsize), lp(def_sr, vsize), quad(def_sr, vsize),
+        sum(vsize) {
+    for (std::size_t k = 0; k < 8; k++)
+      combs.emplace_back(S(0.0011 + 0.00037 * k), def_sr, vsize);
+  }
+
+  void tail(S th) {
+    for (auto &c : combs)
+      c.tail(th);
+    svf.tail(th);
+    lp.tail(th);
+    quad.tail(th);
+  }
+
+  bool idle() const {
+    for (auto &c : combs)
+      if (!c.idle())
+        return false;
+    return svf.idle() && lp.idle() && quad.idle();
+  }
+
+  const sig_vector<S> &operator()(const sig_vector<S> &in) {
+    std::fill(sum.begin(), sum.end(), 0);
+    for (std::size_t k = 0; k < combs.size(); k++) {
+      auto &c = combs[k](in, 0, 0.8);
+      for (std::size_t n = 0; n < sum.size(); n++)
+        sum[n] += c[n] * 0.125;
+    }
+    return quad(lp(svf(sum, 2000, 0.1), 3000, 0.5));
+  }
+};
+
+/* runs the patch for secs seconds after a 50 ms noise burst,
+   printing the cost in ns/sample for each segment of seg seconds;
+   returns the total time in ms */
+template <typename S>
+double run(Patch<S> &p, std::size_t vsize, double secs, double seg,
+           std::vector<double> &segs) {
+  Noise<S> noise(vsize);
+  sig_vector<S> silence(vsize, 0);
+  std::size_t blocks = secs * def_sr / vsize, burst = 0.05 * def_sr / vsize;
+  std::size_t per = seg * def_sr / vsize;
+  volatile S sink = 0;
+  double total = 0;
+  segs.clear();
+  auto t0 = std::chrono::steady_clock::now();
+  for (std::size_t b = 0; b < blocks; b++) {
+    sink = p(b < burst ? noise(0.5) : silence)[0];
+    if ((b + 1) % per == 0) {
+      auto t1 = std::chrono::steady_clock::now();
+      double t = std::chrono::duration<double, std::nano>(t1 - t0).count();
+      segs.push_back(t / (per * vsize));
+      total += t;
+      t0 = t1;
+    }
+  }
+  (void)sink;
+  return total * 1e-6;
+}
+
+template <typename S>
+bool bench(const char *type, std::size_t vsize, double secs, S th) {
+  const double seg = 0.5;
+  std::vector<double> a, b, c;
+  double ta, tb, tc;
+  bool idle, flush;
+  {
+    Patch<S> p(vsize);
+    ta = run(p, vsize, secs, seg, a);
+  }
+  {
+    ftz_scope fz;
+    Patch<S> p(vsize);
+    tb = run(p, vsize, secs, seg, b);
+    flush = ftz();
+  }
+  {
+    ftz_scope fz;
+    Patch<S> p(vsize);
+    p.tail(th);
+    tc = run(p, vsize, secs, seg, c);
+    idle = p.idle();
+  }
+  std::cout << type << " tail, vsize = " << vsize << ", threshold = " << th
+            << " (ns/sample)" << std::endl;
+  std::cout << "  time(s)   plain     ftz       ftz+tail" << std::endl;
+  for (std::size_t k = 0; k < a.size(); k++)
+    std::cout << "  " << (k + 1) * seg << "\t    " << a[k] << "\t" << b[k]
+              << "\t  " << c[k] << std::endl;
+  std::cout << "  total(ms) " << ta << "\t" << tb << "\t  " << tc
+            << std::endl;
+  if (!flush)
+    std::cout << "  (denormal flushing not supported here)" << std::endl;
+  if (!idle)
+    std::cout << "  error: patch not idle at the end of the tail"
+              << std::endl;
+  return idle;
+}
+
+int main(int argc, const char *argv[]) {
+  std::size_t vsize = argc > 1 ? std::atoi(argv[1]) : def_vsize;
+  double secs = argc > 2 ? std::atof(argv[2]) : 10;
+  if (vsize < 1)
+    vsize = 1;
+  bool ok = bench<float>("float ", vsize, secs, 1e-7f);
+  ok = bench<double>("double", vsize, secs, 1e-7) && ok;
+  return ok ? 0 : 1;
+}
@@ -66,13 +66,13 @@ struct Synth {
       std::size_t n = 0;
       sigmoid.resize(def_ftlen);
       for (auto &s : sigmoid) {
-        s = std::tanhf((smax / sigmoid.size()) * n++ - smax / 2);
+        s = std::tanh((smax / sigmoid.size()) * n++ - smax / 2);
       }
     }
   }
 
-  const std::vector<float> &operator()(float a, float f, float dr, bool gate,
-                                       std::size_t vsiz = 0) {
+  const sig_vector<float> &operator()(float a, float f, float dr, bool gate,
+                                      std::size_t vsiz = 0) {
     if (vsiz) {
       osc.vsize(vsiz);
       env.vsize(vsiz);
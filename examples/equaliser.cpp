@@ -39,14 +39,14 @@ template <typename S> struct Equaliser {
   Equaliser(std::size_t nf, S fs = def_sr, std::size_t vsize = def_vsize)
       : eq(nf, Eq<S>(fs, vsize)){};
 
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &gs,
-                                   const std::vector<S> &f,
-                                   const std::vector<S> &bw) {
-    auto s = &in;
+  span<const S> operator()(const std::vector<S> &in,
+                           const std::vector<S> &gs,
+                           const std::vector<S> &f,
+                           const std::vector<S> &bw) {
+    span<const S> s(in);
     for (std::size_t n = 0; n < gs.size(); n++)
-      s = &eq[n](*s, gs[n], f[n], bw[n]);
-    return *s;
+      s = eq[n](s, gs[n], f[n], bw[n]);
+    return s;
   }
 };
 
@@ -98,7 +98,7 @@ int main(int argc, const char **argv) {
       n = sf_read_float(fpin, buffer.data(), def_vsize);
       if (n) {
         buffer.resize(n);
-        auto &out = eq(buffer, g, f, b);
+        auto out = eq(buffer, g, f, b);
         sf_write_float(fpout, out.data(), n);
       } else
         break;
@@ -50,8 +50,8 @@ struct Flanger {
   Flanger(float maxdt, float sr)
       : lfo(sr), delay(maxdt, sr), gain(), mxdel(maxdt) {}
 
-  const std::vector<float> &operator()(const std::vector<float> &in, float fr,
-                                       float fdb, float g) {
+  const sig_vector<float> &operator()(const std::vector<float> &in, float fr,
+                                      float fdb, float g) {
     lfo.vsize(in.size());
     return gain(delay(in, lfo(mxdel, fr), fdb), g);
   }
@@ -26,6 +26,7 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE
 
+#include "Expr.h"
 #include "Func.h"
 #include "OnePole.h"
 #include <cmath>
@@ -36,22 +37,21 @@
 
 using namespace Aurora;
 
-template <typename S> S scl(S a, S b) { return a * b; }
 template <typename S> S pos(S a) { return a < 0 ? -a : a; }
 
 template <typename S> struct Follow {
   OnePole<S> filter;
   Func<S, pos<S>> abs;
-  BinOp<S, scl<S>> amp;
+  Eval<S> amp;
   S fr;
   S g;
 
   Follow(S ga, S f = 10, S fs = def_sr, std::size_t vsize = def_vsize)
       : filter(fs, vsize), abs(vsize), amp(vsize), fr(f), g(ga){};
 
-  const std::vector<S> &operator()(const std::vector<S> &in1,
-                                   const std::vector<S> &in2) {
-    return amp(g, amp(in1, filter(abs(in2), fr)));
+  const sig_vector<S> &operator()(const std::vector<S> &in1,
+                                  const std::vector<S> &in2) {
+    return amp(g * (lazy(in1) * lazy(filter(abs(in2), fr))));
   }
 };
 
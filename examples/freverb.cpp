@@ -27,6 +27,7 @@
 // POSSIBILITY OF SUCH DAMAGE
 
 #include "Del.h"
+#include "Expr.h"
 #include <array>
 #include <cmath>
 #include <cstdlib>
@@ -36,15 +37,13 @@
 
 using namespace Aurora;
 
-template <typename S> inline S scl(S a, S b) { return a * b; }
 template <typename S> struct Reverb {
 static  constexpr S dt[4] = {0.037, 0.031, 0.029, 0.023};
 static constexpr S adt[2] = {0.01, 0.0017};
 
   std::array<Del<S, lp_delay>, 4> combs;
   std::array<Del<S>, 2> apfs;
-  Mix<S> mix;
-  BinOp<S, scl> gain;
+  Eval<S> wet, out;
   std::array<std::vector<S>, 4> mem;
   std::array<S, 4> g;
   S rvt;
@@ -79,21 +78,22 @@ static constexpr S adt[2] = {0.01, 0.0017};
                Del<S, lp_delay>(dt[2], fs, vsize),
                Del<S, lp_delay>(dt[3], fs, vsize)}),
         apfs({Del<S>(adt[0], fs, vsize), Del<S>(adt[1], fs, vsize)}),
-        mix(vsize), gain(vsize), mem({std::vector<S>(2), std::vector<S>(2),
-                                      std::vector<S>(2), std::vector<S>(2)}),
+        wet(vsize), out(vsize), mem({std::vector<S>(2), std::vector<S>(2),
+                                     std::vector<S>(2), std::vector<S>(2)}),
         g({0, 0, 0, 0}) {
     reverb_time(rvt);
     lp_freq(lpf, fs);
   };
 
-  const std::vector<S> &operator()(const std::vector<S> &in, S rmx) {
+  const sig_vector<S> &operator()(const std::vector<S> &in, S rmx) {
     S ga0 = 0.7;
     S ga1 = 0.7;
-    auto &s = gain(0.25, mix(combs[0](in, 0, g[0], 0, &mem[0]),
-                             combs[1](in, 0, g[1], 0, &mem[1]),
-                             combs[2](in, 0, g[2], 0, &mem[2]),
-                             combs[3](in, 0, g[3], 0, &mem[3])));
-    return mix(in, gain(rmx, apfs[1](apfs[0](s, 0, ga0, -ga0), 0, ga1, -ga1)));
+    auto &s = wet(0.25 * mix(lazy(combs[0](in, 0, g[0], 0, &mem[0])),
+                             lazy(combs[1](in, 0, g[1], 0, &mem[1])),
+                             lazy(combs[2](in, 0, g[2], 0, &mem[2])),
+                             lazy(combs[3](in, 0, g[3], 0, &mem[3]))));
+    return out(lazy(in) +
+               rmx * lazy(apfs[1](apfs[0](s, 0, ga0, -ga0), 0, ga1, -ga1)));
   }
 };
 
@@ -25,6 +25,8 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE
 
+#ifndef _GRAIN_H_
+#define _GRAIN_H_
 #include "Env.h"
 #include "Osc.h"
 
@@ -72,6 +74,9 @@ template <typename S> struct Grain {
     env.vsize(vs);
   }
 
+  /** true if the grain has finished (output is silent) */
+  bool silent() const { return off; }
+
   /** play grain for set duration with amp a and pitch p */
   auto &operator()(S a, S p) {
     if (t < gdr) {
@@ -168,6 +173,8 @@ template <typename S> struct GrainGen {
       std::fill(s.begin()+n,s.begin()+n+ddm,0);
       for (auto &grain: grains) {
         std::size_t j = n;
+        if (grain.silent())
+          continue;
 	grain.vsize(ddm);
         for (auto &o : grain(a,p)) 
           s[j++] += o;
@@ -201,12 +208,14 @@ template <typename S> struct GrainGen {
     S ppan = 1 - pan;
     std::size_t j;
     for (auto &grain: grains) {
+      if (!grain.silent()) {
         j = 0;
 	grain.vsize(vs);
         for (auto &o : grain(am,f,pm)) {
           s[j] += o*ppan;
           s2[j++] += o*(1.-ppan);
 	}
+      }
       ppan = ch ? pan : 1. - pan;
       ch = !ch ;
     }
@@ -221,3 +230,4 @@ template <typename S> struct GrainGen {
   
 };
 } // namespace Aurora
+#endif // _GRAIN_H_
@@ -34,7 +34,7 @@
 namespace Aurora {
 
 template <typename S>
-inline S kp(S rp, std::size_t wp, const std::vector<S> &del,
+inline S kp(S rp, std::size_t wp, const sig_vector<S> &del,
             std::vector<S> *mem) {
   std::size_t ds = del.size();
   S x = linear_interp(rpos(rp, wp, ds), del);
@@ -119,7 +119,7 @@ template <typename S> struct Karplus {
 
   void note_off() { gate = 0; }
 
-  const std::vector<S> &operator()(S a, S fr, S dt, std::size_t vsiz = 0) {
+  const sig_vector<S> &operator()(S a, S fr, S dt, std::size_t vsiz = 0) {
     if (vsiz)
       vsize(vsiz);
     fr = fr > 20 ? fr : 20;
@@ -44,8 +44,8 @@ struct Synth {
       : att(0.f), dec(0.f), sus(0.f), env(ads_gen(att, dec, sus), rt, sr),
         noise(){};
 
-  const std::vector<float> &operator()(float a, bool gate,
-                                       std::size_t vsiz = 0) {
+  const sig_vector<float> &operator()(float a, bool gate,
+                                      std::size_t vsiz = 0) {
     if (vsiz)
       noise.vsize(vsiz);
     return env(noise(a), gate);
@@ -59,13 +59,13 @@ struct Synth {
       std::size_t n = 0;
       sigmoid.resize(def_ftlen);
       for (auto &s : sigmoid) {
-        s = std::tanhf((smax / sigmoid.size()) * n++ - smax / 2);
+        s = std::tanh((smax / sigmoid.size()) * n++ - smax / 2);
       }
     }
   }
 
-  const std::vector<float> &operator()(float a, float f, float dr, bool gate,
-                                       std::size_t vsiz = 0) {
+  const sig_vector<float> &operator()(float a, float f, float dr, bool gate,
+                                      std::size_t vsiz = 0) {
     if (vsiz) {
       osc.vsize(vsiz);
       env.vsize(vsiz);
@@ -86,8 +86,11 @@ int main(int argc, const char *argv[]) {
 
     std::vector<Synth> sy;
     std::vector<float> sig(def_vsize);
-    sy.push_back(Synth(rel, sr));
-    sy.push_back(Synth(rel, sr));
+    // env refers to each Synth's own att, dec and sus, so the
+    // objects are built in place and never copied or moved
+    sy.reserve(2);
+    sy.emplace_back(rel, sr);
+    sy.emplace_back(rel, sr);
     bool gate = 1;
     for (int n = 0; n < sr * dur; n += def_vsize) {
       int i = 0;
@@ -51,7 +51,7 @@ template <typename S> struct Opm {
     return env(osc(a, f), gate);
   }
 
-  auto &operator()(S a, S f, const std::vector<S> &pm, bool gate) {
+  auto &operator()(S a, S f, span<const S> pm, bool gate) {
     return env(osc(a, f, amp(o2pi, pm)), gate);
   }
 };
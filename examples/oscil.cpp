@@ -46,8 +46,8 @@ struct Synth {
     }
   };
 
-  const std::vector<float> &operator()(float a, float f, bool gate,
-                                       std::size_t vsiz = 0) {
+  const sig_vector<float> &operator()(float a, float f, bool gate,
+                                      std::size_t vsiz = 0) {
     if (vsiz)
       osc.vsize(vsiz);
     return env(osc(a, f), gate);
@@ -46,8 +46,8 @@ struct Synth {
         env(ads_gen(att, dec, sus), rt, sr), osc1(&wave, sr), osc2(&wave, sr),
         mix(){};
 
-  const std::vector<float> &operator()(float a, float f, float pwm, bool gate,
-                                       std::size_t vsiz = 0) {
+  const sig_vector<float> &operator()(float a, float f, float pwm, bool gate,
+                                      std::size_t vsiz = 0) {
     if (vsiz) {
       osc1.vsize(vsiz);
       osc2.vsize(vsiz);
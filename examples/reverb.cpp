@@ -27,6 +27,7 @@
 // POSSIBILITY OF SUCH DAMAGE
 
 #include "Conv.h"
+#include "Resample.h"
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
@@ -66,7 +67,7 @@ struct ConvReverb {
     c3.reset(&ir3);
   }
 
-  const std::vector<S> &operator()(const std::vector<S> &in, S g) {
+  const sig_vector<S> &operator()(const std::vector<S> &in, S g) {
     return mix(mix(c1(in,g*0.3),c2(in,g*0.3)),c3(in,g*0.3));
   }
 
@@ -110,11 +111,11 @@ int main(int argc, const char **argv) {
     sf_close(fpir);
     if ((fpin = sf_open(argv[2], SFM_READ, &sfinfo)) != NULL) {
 
-      if (sfinfoir.samplerate != sfinfo.samplerate) {
-        std::cout << "sample rates do not match\n";
-        sf_close(fpin);
-        return 1;
-      }
+      // an IR recorded at another rate is converted to the input rate
+      if (sfinfoir.samplerate != sfinfo.samplerate)
+        impulse = resample<double>(
+            impulse, (double)sfinfo.samplerate / sfinfoir.samplerate, false,
+            RS_BEST);
 
       if (sfinfo.channels < 2) {
         fpout = sf_open(argv[3], SFM_WRITE, &sfinfo);
@@ -50,8 +50,8 @@ public:
 
   S fs() { return car.fs(); }
 
-  const std::vector<S> &operator()(S a, S fc, S fm0, S fm1, S z0, S z1,
-                                   std::size_t vsiz = 0) {
+  const sig_vector<S> &operator()(S a, S fc, S fm0, S fm1, S z0, S z1,
+                                  std::size_t vsiz = 0) {
     if (vsiz)
       mod0.vsize(vsiz);
     auto &s0 = add(fm1, mod0(z0 * fm0, fm0));
@@ -69,7 +69,7 @@ int main(int argc, const char *argv[]) {
     auto fr = std::atof(argv[3]);
     Aurora::StackedFM<double> fm(sr);
     for (int n = 0; n < fm.fs() * dur; n += fm.vsize()) {
-      const std::vector<double> &out = fm(amp, fr, fr, fr, 3, 2);
+      auto &out = fm(amp, fr, fr, fr, 3, 2);
       for (auto s : out)
         std::cout << s << std::endl;
     }
@@ -52,8 +52,8 @@ template <typename S> struct StackedPM {
 
   S fs() { return car.fs(); }
 
-  const std::vector<S> &operator()(S a, S fc, S fm0, S fm1, S z0, S z1,
-                                   bool gate, std::size_t vsiz = 0) {
+  const sig_vector<S> &operator()(S a, S fc, S fm0, S fm1, S z0, S z1,
+                                  bool gate, std::size_t vsiz = 0) {
     if (vsiz) {
       env.vsize(vsiz);
       mod0.vsize(vsiz);
@@ -81,7 +81,7 @@ int main(int argc, const char *argv[]) {
     for (int n = 0; n < fm.fs() * (dur + 0.91); n += fm.vsize()) {
       if (n > dur * fm.fs())
         gate = 0;
-      const std::vector<double> &out =
+      auto &out =
           fm(amp, fr, fr * .999f, fr * 1.001f, 2, 3, gate);
       for (auto s : out)
         std::cout << s << std::endl;
@@ -66,7 +66,7 @@ int main(int argc, const char **argv) {
 	float gain = atof(argv[5]);
         std::vector<float> buffer1(def_vsize);
 	std::vector<float> buffer2(def_vsize);
-        Conv<float> conv(len > def_psize ? len : def_psize);
+        Conv<float> conv(len > (int)def_psize ? len : def_psize);
 	//conv.reset(len > def_psize ? len : def_psize);
         do {
           n1 = sf_read_float(fpir, buffer1.data(), def_vsize);
@@ -110,10 +110,10 @@ namespace Aurora {
   protected:
     std::vector<std::vector<std::complex<S>>> del;
     std::vector<std::vector<std::complex<S>>> del2;
-    std::vector<std::complex<S>> mix;
-    std::vector<S> inbuf;
-    std::vector<S> inbuf2;
-    std::vector<S> olabuf;
+    aligned_vector<std::complex<S>> mix;
+    aligned_vector<S> inbuf;
+    aligned_vector<S> inbuf2;
+    aligned_vector<S> olabuf;
     std::size_t p, sn, psize;
     FFT<S> fft;
     bool meth;
@@ -152,13 +152,50 @@ namespace Aurora {
       return s;
     }
 
-    void transform(const std::vector<S> &in,
+    void transform(const aligned_vector<S> &in,
 		   std::vector<std::vector<std::complex<S>>> &d) {
       fft.transform(in);
       auto &v = fft.vector();
       std::copy(v.begin(), v.end(), d[p].begin());
     }				   
 
+    /* sets up the partitions, clearing all state, and reallocating
+       only if sizes change (never if AURORA_RT_SAFE is defined,
+       when the change is refused and false returned) */
+    bool layout(std::size_t np, std::size_t ps, bool two) {
+      if (np != del.size() || ps != psize || (two && np != del2.size())) {
+#ifdef AURORA_RT_SAFE
+#ifdef AURORA_RT_GUARD
+	rt_limit_hook(np * ps, del.size() * psize);
+#endif
+	return false;
+#else
+	del = std::vector<std::vector<std::complex<S>>>
+	  (np, std::vector<std::complex<S>>(ps + 1));
+	del2 = two ? del : std::vector<std::vector<std::complex<S>>>();
+	mix = aligned_vector<std::complex<S>>(ps + 1);
+	inbuf = aligned_vector<S>(2 * ps);
+	inbuf2 = aligned_vector<S>(two ? 2 * ps : 0);
+	olabuf = aligned_vector<S>(ps);
+	fft = FFT<S>(ps * 2, !packed, inverse);
+	psize = ps;
+#endif
+      } else {
+	for (auto &d : del)
+	  std::fill(d.begin(), d.end(), 0);
+	for (auto &d : del2)
+	  std::fill(d.begin(), d.end(), 0);
+	std::fill(mix.begin(), mix.end(), 0);
+	std::fill(inbuf.begin(), inbuf.end(), 0);
+	std::fill(inbuf2.begin(), inbuf2.end(), 0);
+	std::fill(olabuf.begin(), olabuf.end(), 0);
+	fft.transform(inbuf);
+      }
+      p = 0;
+      sn = 0;
+      return true;
+    }
+
   public:
     /** Constructor \n
 	IR: impulse response table\n
@@ -188,15 +225,18 @@ namespace Aurora {
       meth(ola){};
 
     /** Convolution \n
+	out: caller-provided output \n
 	in: input \n
-	scal: output ampltude scaling
+	scal: output ampltude scaling \n
+	returns out, trimmed to the input size
     */
-    const std::vector<S> &operator()(const std::vector<S> &in, S scal) {
-      if(ir == nullptr) return vector();
+    span<S> operator()(span<S> out, span<const S> in, S scal) {
+      if(ir == nullptr) return out.first(0);
       std::size_t n = 0;
       S *bufin = inbuf.data();
       S *obuff = olabuf.data();
       std::size_t sz = psize;
+      out = out.first(in.size());
       return meth ? process(
 			    [&]() {
 			      auto s =
@@ -211,7 +251,7 @@ namespace Aurora {
 			      }
 			      return s * scal;
 			    },
-			    in.size())
+			    out)
 	: process(
 		  [&]() {
 		    auto s =
@@ -225,12 +265,19 @@ namespace Aurora {
 		    }
 		    return s * scal;
 		  },
-		  in.size());
+		  out);
     }
 
-    const std::vector<S> &operator()(const std::vector<S> &in1,
-				     const std::vector<S> &in2, S scal) {
-      if(del2.size() == 0) return vector();
+    /** Convolution \n
+	out: caller-provided output \n
+	in1: input \n
+	in2: impulse response input \n
+	scal: output ampltude scaling \n
+	returns out, trimmed to the input size
+    */
+    span<S> operator()(span<S> out, span<const S> in1, span<const S> in2,
+		       S scal) {
+      if(del2.size() == 0) return out.first(0);
       std::size_t n = 0;
       S *bufin = inbuf.data();
       S *bufin2 = inbuf2.data();
@@ -250,35 +297,48 @@ namespace Aurora {
 	  n++;
 	  return s *scal;
 	},
-	in1.size());
+	out.first(in1.size()));
+    }
+
+    /** Convolution \n
+	in: input \n
+	scal: output ampltude scaling
+    */
+    const sig_vector<S> &operator()(span<const S> in, S scal) {
+      if(ir == nullptr) return vector();
+      (*this)(this->sig_span(in.size()), in, scal);
+      return vector();
     }
 
-    void reset(const IR<S> *imp) {
+    const sig_vector<S> &operator()(span<const S> in1,
+				     span<const S> in2, S scal) {
+      if(del2.size() == 0) return vector();
+      (*this)(this->sig_span(in1.size()), in1, in2, scal);
+      return vector();
+    }
+
+    /** Reset the impulse response \n
+	imp: impulse response table \n
+	returns false if the table was refused: if AURORA_RT_SAFE
+	is defined, only tables with the current partition size and
+	number are taken, reusing memory
+    */
+    bool reset(const IR<S> *imp) {
+      if (!layout(imp->nparts(), imp->psize(), false))
+	return false;
       ir = imp;
-      psize = ir->psize();	
-      del = std::vector<std::vector<std::complex<S>>>
-	(ir->nparts(), std::vector<std::complex<S>>(psize + 1));
-      mix = std::vector<std::complex<S>>(psize + 1);
-      inbuf = std::vector<S>(2 * psize);
-      olabuf = std::vector<S>(psize);
-      p = 0;
-      sn = 0;
-      fft = FFT<S>(psize * 2, !packed, inverse);    
+      return true;
     }
 
-    void reset(std::size_t len, std::size_t psiz = def_psize) {
-      del = std::vector<std::vector<std::complex<S>>>
-	(len/psize, std::vector<std::complex<S>>(psize + 1));
-      del2 = std::vector<std::vector<std::complex<S>>>
-	(len/psize,std::vector<std::complex<S>>(psize + 1));
-      mix = std::vector<std::complex<S>>(psize + 1);
-      inbuf = std::vector<S>(2 * psize);
-      inbuf2 = std::vector<S>(2 * psize);
-      olabuf = std::vector<S>(psize);
-      p = 0;
-      sn = 0;
-      fft = FFT<S>(psize * 2, !packed, inverse);
-      psize = psiz;     
+    /** Reset the convolution length \n
+	len: convolution length \n
+	psize: partition size \n
+	returns false if the length was refused: if AURORA_RT_SAFE
+	is defined, only the current length and partition size are
+	taken, reusing memory
+    */
+    bool reset(std::size_t len, std::size_t psiz = def_psize) {
+      return layout(len / psiz, psiz, true);
       } 
   };
 
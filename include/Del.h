@@ -42,7 +42,7 @@ namespace Aurora {
     returns a sample from the delay line
 */
 template <typename S>
-inline S fixed_delay(S nop, std::size_t wp, const std::vector<S> &d,
+inline S fixed_delay(S nop, std::size_t wp, const sig_vector<S> &d,
                      std::vector<S> *nop1) {
   (void)nop;
   (void)nop1;
@@ -69,7 +69,7 @@ template <typename S> inline S rpos(S rp, std::size_t wp, std::size_t ds) {
     returns a sample from the delay line floor(rp) samples behind wp
 */
 template <typename S>
-inline S vdelay(S rp, std::size_t wp, const std::vector<S> &del,
+inline S vdelay(S rp, std::size_t wp, const sig_vector<S> &del,
                 std::vector<S> *nop) {
   (void)nop;
   std::size_t ds = del.size();
@@ -86,7 +86,7 @@ inline S vdelay(S rp, std::size_t wp, const std::vector<S> &del,
     linearly interpolated
 */
 template <typename S>
-inline S vdelayi(S rp, std::size_t wp, const std::vector<S> &del,
+inline S vdelayi(S rp, std::size_t wp, const sig_vector<S> &del,
                  std::vector<S> *nop) {
   (void)nop;
   std::size_t ds = del.size();
@@ -103,7 +103,7 @@ inline S vdelayi(S rp, std::size_t wp, const std::vector<S> &del,
     cubic interpolated
 */
 template <typename S>
-inline S vdelayc(S rp, std::size_t wp, const std::vector<S> &del,
+inline S vdelayc(S rp, std::size_t wp, const sig_vector<S> &del,
                  std::vector<S> *nop) {
   (void)nop;
   std::size_t ds = del.size();
@@ -118,7 +118,7 @@ inline S vdelayc(S rp, std::size_t wp, const std::vector<S> &del,
    \n returns a convolution sample
 */
 template <typename S>
-inline S lp_delay(S nop, std::size_t wp, const std::vector<S> &d,
+inline S lp_delay(S nop, std::size_t wp, const sig_vector<S> &d,
                   std::vector<S> *mem) {
   S ym1 = (*mem)[0];
   S coef = (*mem)[1];
@@ -136,7 +136,7 @@ inline S lp_delay(S nop, std::size_t wp, const std::vector<S> &d,
     returns a convolution sample
 */
 template <typename S>
-inline S fir(S nop, std::size_t wp, const std::vector<S> &del,
+inline S fir(S nop, std::size_t wp, const sig_vector<S> &del,
              std::vector<S> *ir) {
   auto dl = del.begin() + wp;
   S mx = 0;
@@ -150,15 +150,37 @@ inline S fir(S nop, std::size_t wp, const std::vector<S> &del,
 
 /** Del class \n
     Generic templated delay line \n
-    S: sample type
+    S: sample type \n
+    FN: delay function, taking the delay line as a
+    const sig_vector<S> & (functions written for the
+    std::vector lines of earlier versions need this signature)
 */
-template <typename S = float, S (*FN)(S, std::size_t, const std::vector<S> &,
-                              std::vector<S> *) = fixed_delay>
+template <typename S = float,
+          S (*FN)(S, std::size_t, const sig_vector<S> &, std::vector<S> *) =
+              fixed_delay>
 class Del : public SndBase<S> {
   using SndBase<S>::process;
   S fs;
   std::size_t wp;
-  std::vector<S> del;
+  sig_vector<S> del;
+  Tail<S> tl;
+  std::size_t qt;
+
+  /* the line is taken as drained once a whole delay length of
+     quiet input and output has gone through it */
+  void decay(span<const S> in, span<const S> out) {
+    if (!tl.on())
+      return;
+    if (tl.quiet(in) && tl.quiet(out)) {
+      qt += out.size();
+      if (qt >= del.size()) {
+        std::fill(del.begin(), del.end(), 0);
+        tl.idle(true);
+        qt = 0;
+      }
+    } else
+      qt = 0;
+  }
 
   S delay(S in, S dt, S fdb, S fwd, std::size_t &p, std::vector<S> *mem) {
     S s = FN(dt, p, del, mem);
@@ -179,7 +201,7 @@ public:
   */
   Del(S maxdt, S sr = def_sr, std::size_t vsize = def_vsize)
       : SndBase<S>(vsize), fs(sr), wp(0),
-        del(maxdt * fs < 1 ? 1 : maxdt * fs){};
+        del(maxdt * fs < 1 ? 1 : maxdt * fs), qt(0){};
 
     /** Constructor \n
       maxdt: maximum delay time in Samples \n
@@ -189,93 +211,287 @@ public:
   */
    Del(std::size_t maxdt, std::size_t vsize = def_vsize)
       : SndBase<S>(vsize), fs(def_sr), wp(0),
-        del(maxdt < 1 ? 1 : maxdt){};
+        del(maxdt < 1 ? 1 : maxdt), qt(0){};
 
 
   /** Delay \n
+      out: caller-provided output \n
       in: audio \n
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in) {
+  span<S> operator()(span<S> out, span<const S> in) {
     std::size_t n = 0, p = wp;
-    auto &s = process([&]() { return delay(in[n++], del.size(), 0, 0, p, nullptr); }, in.size());
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    out = process(
+        [&]() { return delay(in[n++], del.size(), 0, 0, p, nullptr); }, out);
     wp = p;
-    return s;
+    decay(in, out);
+    return out;
   }
 
-  
   /** Delay \n
+      out: caller-provided output \n
       in: audio \n
       dt: delay time \n
       fdb: feedback gain \n
       fwd: feedforward gain
-      mem: optional aux memory
+      mem: optional aux memory \n
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S dt, S fdb = 0,
-                                   S fwd = 0, std::vector<S> *mem = nullptr) {
+  span<S> operator()(span<S> out, span<const S> in, S dt, S fdb = 0, S fwd = 0,
+                     std::vector<S> *mem = nullptr) {
     std::size_t n = 0, p = wp;
-    auto &s = process([&]() { return delay(in[n++], dt*fs, fdb, fwd, p, mem); },
-                      in.size());
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    out = process(
+        [&]() { return delay(in[n++], dt * fs, fdb, fwd, p, mem); }, out);
     wp = p;
-    return s;
+    decay(in, out);
+    return out;
   }
 
   /** Delay \n
+      out: caller-provided output \n
       in: audio \n
       dt: delay time \n
       fdb: feedback gain \n
       fwd: feedforward gain \n
-      mem: optional aux memory
+      mem: optional aux memory \n
+      returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &dt, S fdb = 0,
-                                   S fwd = 0, std::vector<S> *mem = nullptr) {
+  span<S> operator()(span<S> out, span<const S> in, span<const S> dt,
+                     S fdb = 0, S fwd = 0, std::vector<S> *mem = nullptr) {
     std::size_t n = 0, p = wp;
-
-    auto &s = process(
+    out = out.first(in.size() < dt.size() ? in.size() : dt.size());
+    if (tl.skip(in.first(out.size())))
+      return this->mute(out);
+    out = process(
         [&]() {
           auto s = delay(in[n], dt[n] * fs, fdb, fwd, p, mem);
           n++;
           return s;
         },
-        in.size() < dt.size() ? in.size() : dt.size());
+        out);
     wp = p;
-    return s;
+    decay(in.first(out.size()), out);
+    return out;
   }
-  
+
+  /** Delay \n
+      in: audio \n
+  */
+  const sig_vector<S> &operator()(span<const S> in) {
+    (*this)(this->sig_span(in.size()), in);
+    return this->vector();
+  }
+
+  /** Delay \n
+      in: audio \n
+      dt: delay time \n
+      fdb: feedback gain \n
+      fwd: feedforward gain
+      mem: optional aux memory
+  */
+  const sig_vector<S> &operator()(span<const S> in, S dt, S fdb = 0, S fwd = 0,
+                                  std::vector<S> *mem = nullptr) {
+    (*this)(this->sig_span(in.size()), in, dt, fdb, fwd, mem);
+    return this->vector();
+  }
+
+  /** Delay \n
+      in: audio \n
+      dt: delay time \n
+      fdb: feedback gain \n
+      fwd: feedforward gain \n
+      mem: optional aux memory
+  */
+  const sig_vector<S> &operator()(span<const S> in, span<const S> dt, S fdb = 0,
+                                  S fwd = 0, std::vector<S> *mem = nullptr) {
+    (*this)(this->sig_span(in.size() < dt.size() ? in.size() : dt.size()), in,
+            dt, fdb, fwd, mem);
+    return this->vector();
+  }
+
   /** reset the delayline object \n
       maxdt: max delay time \n
-      sr: sampling rate
+      sr: sampling rate \n
+      returns the delay line size, which is less than requested if
+      AURORA_RT_SAFE is defined and the delay memory would need to
+      grow beyond its current allocation
   */
-  void reset(S maxdt, S sr) {
+  std::size_t reset(S maxdt, S sr) {
     fs = sr;
-    wp = 0;
+    wp = qt = 0;
+    tl.idle(false);
     del.clear();
-    del.resize(fs * maxdt);
+    return rt_resize(del, fs * maxdt);
+  }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when a whole delay length of input and output has gone
+      through the line within the threshold, the line is cleared
+      and the delay goes idle, skipping processing until
+      non-silent input arrives
+  */
+  void tail(S th) {
+    tl.threshold(th);
+    qt = 0;
   }
 
+  /** Idle state query \n
+      returns true if the delay is idle
+  */
+  bool idle() const { return tl.idle(); }
+
 
   std::size_t write_pos() const {
     return wp;
   }
 
-  const std::vector<S> &delayline() const {
+  const sig_vector<S> &delayline() const {
     return del;
   }
 
   
 };
 
+/** DelN class \n
+    Multichannel templated delay line \n
+    all channels share delay time and read/write positions \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N,
+          S (*FN)(S, std::size_t, const sig_vector<S> &, std::vector<S> *) =
+              fixed_delay>
+class DelN : public SndBaseN<S, N> {
+  using SndBaseN<S, N>::minsize;
+  S fs;
+  std::size_t wp;
+  std::array<sig_vector<S>, N> del;
+
+  /* channels are processed in turn, each one running a block
+     from the same write position */
+  template <typename F>
+  channels<S, N> run(F &&dtime, const channels<S, N> &in, std::size_t sz,
+                     S fdb, S fwd, std::vector<S> *mem) {
+    std::size_t p = wp;
+    this->vsize(sz);
+    sz = this->vsize();
+    for (std::size_t c = 0; c < N; c++) {
+      auto &d = del[c];
+      const S *x = in[c].data();
+      S *o = this->get_chn(c);
+      std::vector<S> *m = mem ? mem + c : nullptr;
+      p = wp;
+      for (std::size_t n = 0; n < sz; n++) {
+        S s = FN(dtime(n), p, d, m);
+        S w = x[n] + s * fdb;
+        d[p] = w;
+        p = p < d.size() - 1 ? p + 1 : 0;
+        o[n] = w * fwd + s;
+      }
+    }
+    wp = p;
+    return this->signal();
+  }
+
+public:
+  /** Constructor \n
+      maxdt: maximum delay time \n
+      sr: sampling rate \n
+      vsize: vector size
+  */
+  DelN(S maxdt, S sr = def_sr, std::size_t vsize = def_vsize)
+      : SndBaseN<S, N>(vsize), fs(sr), wp(0) {
+    for (auto &d : del)
+      d.resize(maxdt * fs < 1 ? 1 : maxdt * fs);
+  };
+
+  /** Delay \n
+      in: input channels \n
+      returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in) {
+    S dt = del[0].size();
+    return run([&](std::size_t) { return dt; }, in, minsize(in), 0, 0,
+               nullptr);
+  }
+
+  /** Delay \n
+      in: input channels \n
+      dt: delay time \n
+      fdb: feedback gain \n
+      fwd: feedforward gain \n
+      mem: optional aux memory, N vectors (one per channel) \n
+      returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, S dt, S fdb = 0,
+                            S fwd = 0, std::vector<S> *mem = nullptr) {
+    dt *= fs;
+    return run([&](std::size_t) { return dt; }, in, minsize(in), fdb, fwd,
+               mem);
+  }
+
+  /** Delay \n
+      in: input channels \n
+      dt: delay time signal (shared by all channels) \n
+      fdb: feedback gain \n
+      fwd: feedforward gain \n
+      mem: optional aux memory, N vectors (one per channel) \n
+      returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, span<const S> dt,
+                            S fdb = 0, S fwd = 0,
+                            std::vector<S> *mem = nullptr) {
+    std::size_t sz = minsize(in);
+    return run([&](std::size_t n) -> S { return dt[n] * fs; }, in,
+               sz < dt.size() ? sz : dt.size(), fdb, fwd, mem);
+  }
+
+  /** reset the delayline object \n
+      maxdt: max delay time \n
+      sr: sampling rate \n
+      returns the (smallest) delay line size, which is less than
+      requested if AURORA_RT_SAFE is defined and the delay memory
+      would need to grow beyond its current allocation
+  */
+  std::size_t reset(S maxdt, S sr) {
+    fs = sr;
+    wp = 0;
+    std::size_t n = fs * maxdt;
+    for (auto &d : del) {
+      d.clear();
+      std::size_t m = rt_resize(d, fs * maxdt);
+      n = m < n ? m : n;
+    }
+    return n;
+  }
+
+  std::size_t write_pos() const { return wp; }
+
+  /** Delay line access \n
+      c: channel number
+  */
+  const sig_vector<S> &delayline(std::size_t c) const { return del[c]; }
+};
+
 /** Tap class \n
     Taps a delay line \n
     S: sample type
 */
-template <typename S = float, S (*FN)(S, std::size_t, const std::vector<S> &,
-                              std::vector<S> *) = vdelay>
+template <typename S = float,
+          S (*FN)(S, std::size_t, const sig_vector<S> &, std::vector<S> *) =
+              vdelay>
 class Tap : public SndBase<S> {
    using SndBase<S>::process;
    S fs;
 
-  S tap(S dt, const std::vector<S> &del, std::size_t p) {
+  S tap(S dt, const sig_vector<S> &del, std::size_t p) {
     return FN(dt, p, del, nullptr);
   }
 
@@ -290,33 +506,60 @@ class Tap : public SndBase<S> {
 
 
   /** Tap \n
+      out: caller-provided output \n
       del: delay line object \n
       dt: delay time \n
-  */ 
-   const std::vector<S> &operator()(const Del<S> &del,
-                                   const std::vector<S> &dt) {
-     std::size_t n = 0;
-     int64_t pp = del.write_pos() - del.vsize() - 1;
-     auto &d = del.delayline();
+      taps the last block of out.size() samples written to del \n
+      returns out, trimmed to the input size
+  */
+  span<S> operator()(span<S> out, const Del<S> &del, span<const S> dt) {
+    std::size_t n = 0;
+    out = out.first(dt.size());
+    int64_t pp = del.write_pos() - out.size() - 1;
+    auto &d = del.delayline();
     return process(
         [&]() {
-	  pp = pp >= -1 ? pp + 1 : pp + 1 + d.size();
+          pp = pp >= -1 ? pp + 1 : pp + 1 + d.size();
           return tap(dt[n++] * fs, d, pp);
-        }, dt.vsize());
+        },
+        out);
   }
 
-   /** Tap \n
+  /** Tap \n
+      out: caller-provided output \n
       del: delay line object \n
       dt: delay time \n
-  */ 
-   const std::vector<S> &operator()(const Del<S> &del, S dt) {
-     int64_t pp = del.write_pos() - del.vsize() - 1;
-     auto &d = del.delayline();
-     return process([&]() {
-	 pp = pp >= -1 ? pp + 1 : pp + 1 + d.size();
-	 return tap(dt*fs,d, pp); },
-       del.vsize());
-   }
+      taps the last block of out.size() samples written to del \n
+      returns out
+  */
+  span<S> operator()(span<S> out, const Del<S> &del, S dt) {
+    int64_t pp = del.write_pos() - out.size() - 1;
+    auto &d = del.delayline();
+    return process(
+        [&]() {
+          pp = pp >= -1 ? pp + 1 : pp + 1 + d.size();
+          return tap(dt * fs, d, pp);
+        },
+        out);
+  }
+
+  /** Tap \n
+      del: delay line object \n
+      dt: delay time \n
+  */
+  const sig_vector<S> &operator()(const Del<S> &del, span<const S> dt) {
+    (*this)(this->sig_span(dt.size()), del, dt);
+    return this->vector();
+  }
+
+  /** Tap \n
+      del: delay line object \n
+      dt: delay time \n
+  */
+  const sig_vector<S> &operator()(const Del<S> &del, S dt) {
+    (*this)(this->sig_span(del.vsize()), del, dt);
+    return this->vector();
+  }
 
   void reset(S sr) {
     fs = sr;
@@ -29,6 +29,7 @@
 #define _AURORA_ENV_
 
 #include "SndBase.h"
+#include <cmath>
 #include <functional>
 
 namespace Aurora {
@@ -103,8 +104,8 @@ class Env : public SndBase<S> {
   S rt;
   S &p1, &p2, &p3;
 
-  S synth(S e, double &t, bool gate, std::function<S(double, S, S)> fn, S a,
-          S b, S c) {
+  S synth(S e, double &t, bool gate, const std::function<S(double, S, S)> &fn,
+          S a, S b, S c) {
     S s;
     if (gate) {
       s = fn ? fn(t, e, ts) : FN(a, b, c, t, e, ts);
@@ -128,7 +129,7 @@ public:
   */
   Env(std::function<S(double, S, S)> f, S rt, S fs = def_sr,
       std::size_t vsize = def_vsize)
-      : SndBase<S>(vsize), fun(f), prev(0), ts(1. / fs),
+      : SndBase<S>(vsize), fun(f), time(0), prev(0), ts(1. / fs),
      fac(std::pow(0.001, ts / rt)), rt(rt), p1(fac), p2(fac), p3(fac){};
 
   /** Constructor \n
@@ -140,7 +141,7 @@ public:
      vsize: signal vector size
  */
   Env(S &a, S &b, S &c, S rt, S fs = def_sr, std::size_t vsize = def_vsize)
-      : SndBase<S>(vsize), fun(nullptr), prev(0), ts(1. / fs),
+      : SndBase<S>(vsize), fun(nullptr), time(0), prev(0), ts(1. / fs),
   fac(std::pow(0.001, ts / rt)), rt(rt), p1(a), p2(b), p3(c) {}
 
   /** Release time setter
@@ -157,57 +158,97 @@ public:
   }
 
   /** Envelope \n
-      gate: envelope gate
+      out: caller-provided output \n
+      gate: envelope gate \n
+      returns out
    */
-  const std::vector<S> &operator()(bool gate) {
+  span<S> operator()(span<S> out, bool gate) {
+    if (!gate && prev == 0) {
+      time = 0;
+      return this->mute(out);
+    }
     double t = time;
     S e = prev;
     S a = p1, b = p2, c = p3;
-    auto &s =
-        process([&]() { return (e = synth(e, t, gate, fun, a, b, c)); }, 0);
+    process([&]() { return (e = synth(e, t, gate, fun, a, b, c)); }, out);
     prev = e;
     time = t;
-    return s;
+    return out;
   }
 
   /** Envelope \n
+      out: caller-provided output \n
       offs: sig offset
       scal: sig scale
-      gate: envelope gate
+      gate: envelope gate \n
+      returns out
    */
-  const std::vector<S> &operator()(S offs, S scal, bool gate) {
+  span<S> operator()(span<S> out, S offs, S scal, bool gate) {
     double t = time;
     S e = prev;
     S a = p1, b = p2, c = p3;
-    auto &s = process(
+    process(
         [&]() {
           e = synth(e, t, gate, fun, a, b, c);
           return (e * scal + offs);
         },
-        0);
+        out);
     prev = e;
     time = t;
-    return s;
+    return out;
   }
 
   /** Envelope \n
+      out: caller-provided output \n
       in: input signal
-      gate: envelope gate
+      gate: envelope gate \n
+      returns out, trimmed to the input size
    */
-  const std::vector<S> &operator()(const std::vector<S> &in, bool gate) {
+  span<S> operator()(span<S> out, span<const S> in, bool gate) {
+    if (!gate && prev == 0) {
+      time = 0;
+      return this->mute(out.first(in.size()));
+    }
     double t = time;
     S e = prev;
     std::size_t n = 0;
     S a = p1, b = p2, c = p3;
-    auto &s = process(
+    out = process(
         [&]() {
           e = synth(e, t, gate, fun, a, b, c);
           return e * in[n++];
         },
-        in.size());
+        out.first(in.size()));
     prev = e;
     time = t;
-    return s;
+    return out;
+  }
+
+  /** Envelope \n
+      gate: envelope gate
+   */
+  const sig_vector<S> &operator()(bool gate) {
+    (*this)(this->sig_span(0), gate);
+    return this->vector();
+  }
+
+  /** Envelope \n
+      offs: sig offset
+      scal: sig scale
+      gate: envelope gate
+   */
+  const sig_vector<S> &operator()(S offs, S scal, bool gate) {
+    (*this)(this->sig_span(0), offs, scal, gate);
+    return this->vector();
+  }
+
+  /** Envelope \n
+      in: input signal
+      gate: envelope gate
+   */
+  const sig_vector<S> &operator()(span<const S> in, bool gate) {
+    (*this)(this->sig_span(in.size()), in, gate);
+    return this->vector();
   }
 
   /** Sampling rate query \n
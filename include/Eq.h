@@ -25,6 +25,7 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE
 #include "SndBase.h"
+#include <cmath>
 
 namespace Aurora {
 
@@ -37,7 +38,16 @@ template <typename S = float> class Eq : SndBase<S> {
   double z[2];
   double d, a;
   double piosr;
-  S ff, bbw;
+  S ff, bbw, gg;
+  Tail<S> tl;
+  Smooth<S> sm;
+
+  void decay(span<const S> out) {
+    if (tl.on() && tl.quiet(z, 2) && tl.quiet(out)) {
+      z[0] = z[1] = 0;
+      tl.idle(true);
+    }
+  }
 
   S filter(S in, S g, double *z, double d, double a) {
     double w = in + d * (1.0 + a) * z[0] - a * z[1];
@@ -62,20 +72,149 @@ public:
   */
   Eq(S fs = def_sr, std::size_t vsize = def_vsize)
       : SndBase<S>(vsize), z{0., 0.}, d(0.), a(0.), piosr(M_PI / fs), ff(0),
-        bbw(0){};
+        bbw(0), gg(1){};
 
   /** Equalisation
+     out: caller-provided output
      in: input signal
      g: output gain
      fr: centre frequency
      bw: bandwidth
+     returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S g, S fr, S bw) {
+  span<S> operator()(span<S> out, span<const S> in, S g, S fr, S bw) {
     std::size_t n = 0;
-    double dd = d, aa = a;
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    if ((ff != fr || bw != bbw || g != gg) && sm.ramp()) {
+      S f0 = ff, bw0 = bbw, g0 = gg;
+      double c[3] = {d, a, g0};
+      out = process(
+          sm, out, c,
+          [&](double t, double *cn) {
+            coeffs(sm.at(f0, fr, t), sm.at(bw0, bw, t));
+            cn[0] = d;
+            cn[1] = a;
+            cn[2] = sm.at(g0, g, t);
+          },
+          [&](std::size_t i, const double *c) {
+            return filter(in[i], c[2], z, c[0], c[1]);
+          });
+    } else {
+      if (ff != fr || bw != bbw)
+        coeffs(fr, bw);
+      double dd = d, aa = a;
+      out = process([&]() { return filter(in[n++], g, z, dd, aa); }, out);
+    }
+    gg = g;
+    decay(out);
+    return out;
+  }
+
+  /** Equalisation
+     in: input signal
+     g: output gain
+     fr: centre frequency
+     bw: bandwidth
+  */
+  const sig_vector<S> &operator()(span<const S> in, S g, S fr, S bw) {
+    (*this)(this->sig_span(in.size()), in, g, fr, bw);
+    return this->vector();
+  }
+
+  /** Parameter smoothing \n
+      k: coefficient update period in samples (0 turns smoothing off) \n
+      ex: exponential (true) or linear (false) ramps \n
+      when on, gain, frequency and bandwidth changes are ramped
+      across the next block
+  */
+  void smooth(std::size_t k, bool ex = false) { sm.rate(k, ex); }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when the equaliser state and output decay to within the
+      threshold, the equaliser goes idle and skips processing until
+      non-silent input arrives
+  */
+  void tail(S th) { tl.threshold(th); }
+
+  /** Idle state query \n
+      returns true if the equaliser is idle
+  */
+  bool idle() const { return tl.idle(); }
+
+  /** reset object
+      fs: sampling rate
+  */
+  void reset(S fs) {
+    piosr = M_PI / fs;
+    coeffs(ff, bbw);
+  }
+};
+
+/** EqN class \n
+    Multichannel parametric equaliser \n
+    coefficients are computed once and channels
+    are processed as parallel lanes \n
+    S: sample type \n
+    N: number of channels
+ */
+template <typename S, std::size_t N> class EqN : public SndBaseN<S, N> {
+  using SndBaseN<S, N>::process;
+  using SndBaseN<S, N>::minsize;
+  double z[2][N];
+  double d, a;
+  double piosr;
+  S ff, bbw;
+
+  void filter(const S *in, S *o, S g, double *z0, double *z1) {
+    const double da = d * (1.0 + a), aa = a;
+    for (std::size_t c = 0; c < N; c++) {
+      S x = in[c];
+      double w = x + da * z0[c] - aa * z1[c];
+      double y = w * aa - da * z0[c] + z1[c];
+      z1[c] = z0[c];
+      z0[c] = w;
+      o[c] = (S)(0.5 * (y + x + g * (x - y)));
+    }
+  }
+
+  void coeffs(S f, S bw) {
+    S c = tan(piosr * bw);
+    d = std::cos(2 * piosr * f);
+    a = (1. - c) / (1. + c);
+    ff = f;
+    bbw = bw;
+  }
+
+public:
+  /** Constructor \n
+      fs: sampling rate
+      vsize: signal vector size
+  */
+  EqN(S fs = def_sr, std::size_t vsize = def_vsize)
+      : SndBaseN<S, N>(vsize), z{{0}}, d(0.), a(0.), piosr(M_PI / fs), ff(0),
+        bbw(0){};
+
+  /** Equalisation
+     in: input channels
+     g: output gain
+     fr: centre frequency
+     bw: bandwidth
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, S g, S fr, S bw) {
+    double z0[N], z1[N];
     if (ff != fr || bw != bbw)
       coeffs(fr, bw);
-    return process([&]() { return filter(in[n++], g, z, dd, aa); }, in.size());
+    std::copy(z[0], z[0] + N, z0);
+    std::copy(z[1], z[1] + N, z1);
+    auto o = process([&](const S *x, S *y) { filter(x, y, g, z0, z1); }, in,
+                     minsize(in));
+    std::copy(z0, z0 + N, z[0]);
+    std::copy(z1, z1 + N, z[1]);
+    return o;
   }
 
   /** reset object
@@ -0,0 +1,286 @@
+// Executor.h
+// Parallel graph executor
+// work-stealing scheduling of independent nodes
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_EXECUTOR_
+#define _AURORA_EXECUTOR_
+
+#include "Graph.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Aurora {
+
+/** Executor class \n
+    Parallel processing graph executor \n
+    S: sample type \n
+    runs the nodes of a graph on a fixed pool of threads (the
+    calling thread included), each holding a work-stealing deque.
+    A node is queued when all of its inputs have been computed, by
+    the thread that completed the last of them, and idle threads
+    steal from the others. Each block ends on a barrier, so that
+    the call returns when all nodes have run. Nothing is allocated
+    while processing. Worker threads flush denormals to zero
+    whenever the calling thread does (see ftz_scope). Since nodes
+    only ever run after the nodes they depend on and the graph
+    buffers are allocated for concurrent execution, output matches
+    that of the serial graph exactly. \n
+    A block is started with an atomic store: between blocks,
+    workers poll for the next one for up to spin_time and only then
+    park on a condition variable. The calling thread takes a lock
+    (to wake them) only if a worker has parked, that is, after a
+    pause longer than spin_time, so that no lock or system call is
+    made in steady-state processing. \n
+    Concurrent buffers cannot be shared by nodes that may run at the
+    same time, so the graph needs more buffer memory than when run
+    serially (in bench/parallel.cpp, 131072 bytes instead of 3072,
+    43 times as much).
+*/
+template <typename S = float> class Executor : public SndBase<S> {
+  struct Deque {
+    std::unique_ptr<std::atomic<std::size_t>[]> buf;
+    alignas(def_align) std::atomic<std::int64_t> top;
+    alignas(def_align) std::atomic<std::int64_t> bottom;
+  };
+
+  Graph<S> &graph;
+  std::size_t nodes;
+  std::size_t nthr;
+  std::unique_ptr<Deque[]> deques;
+  std::unique_ptr<std::atomic<std::size_t>[]> pending;
+  std::vector<std::size_t> npred;
+  std::vector<std::size_t> roots;
+  std::vector<std::vector<span<const S>>> scratch;
+  span<S> outs;
+  alignas(def_align) std::atomic<std::size_t> done;
+  alignas(def_align) std::atomic<std::size_t> left;
+  std::atomic<std::size_t> gen;
+  std::atomic<std::size_t> parked;
+  bool quit;
+  bool flush;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::vector<std::thread> pool;
+
+  /* owner end of deque: push and take at the bottom,
+     thieves steal from the top (Chase-Lev, fixed capacity) */
+  void push(std::size_t id, std::size_t u) {
+    Deque &d = deques[id];
+    std::int64_t b = d.bottom.load(std::memory_order_relaxed);
+    d.buf[b].store(u, std::memory_order_relaxed);
+    d.bottom.store(b + 1, std::memory_order_release);
+  }
+
+  bool take(std::size_t id, std::size_t &u) {
+    Deque &d = deques[id];
+    std::int64_t b = d.bottom.load(std::memory_order_relaxed) - 1;
+    d.bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = d.top.load(std::memory_order_relaxed);
+    if (t > b) {
+      d.bottom.store(b + 1, std::memory_order_relaxed);
+      return false;
+    }
+    u = d.buf[b].load(std::memory_order_relaxed);
+    if (t == b) {
+      bool won = d.top.compare_exchange_strong(
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      d.bottom.store(b + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  bool steal(std::size_t id, std::size_t &u) {
+    for (std::size_t k = 1; k < nthr; k++) {
+      Deque &d = deques[(id + k) % nthr];
+      std::int64_t t = d.top.load(std::memory_order_acquire);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      std::int64_t b = d.bottom.load(std::memory_order_acquire);
+      if (t < b) {
+        std::size_t x = d.buf[t].load(std::memory_order_relaxed);
+        if (d.top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+          u = x;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /* runs nodes until all of the block is done */
+  void work(std::size_t id) {
+    rt_scope guard;
+    ftz_scope fz(id && flush);
+    std::size_t u;
+    while (done.load(std::memory_order_acquire) < nodes) {
+      if (take(id, u) || steal(id, u)) {
+        graph.run(u, outs, scratch[id].data());
+        for (auto v : graph.succ[u])
+          if (pending[v].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            push(id, v);
+        done.fetch_add(1, std::memory_order_release);
+      } else
+        std::this_thread::yield();
+    }
+  }
+
+  /* polls for a new block for up to spin_time, then parks, only
+     if the poll timed out without one; parked is raised before gen
+     is checked under the lock, and the caller bumps gen before
+     reading parked (both sequentially consistent), so either the
+     worker sees the new block or the caller sees the worker parked
+     and wakes it */
+  void worker(std::size_t id) {
+    std::size_t seen = 0;
+    for (;;) {
+      auto t0 = std::chrono::steady_clock::now();
+      for (int k = 1; gen.load(std::memory_order_acquire) == seen; k++) {
+        if (!(k % 64) && std::chrono::steady_clock::now() - t0 > spin_time)
+          break;
+        std::this_thread::yield();
+      }
+      std::size_t g = gen.load(std::memory_order_acquire);
+      if (g != seen)
+        seen = g;
+      else {
+        std::unique_lock<std::mutex> lock(mtx);
+        parked.fetch_add(1);
+        cv.wait(lock, [&]() { return quit || gen.load() != seen; });
+        parked.fetch_sub(1);
+        if (quit)
+          return;
+        seen = gen.load();
+      }
+      work(id);
+      left.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+public:
+  /** Time workers poll for a new block before parking */
+  static constexpr std::chrono::microseconds spin_time{5000};
+
+  /** Constructor \n
+      g: processing graph, compiled by the executor for
+      concurrent execution \n
+      threads: number of threads, including the calling thread \n
+      the graph should not be changed or recompiled while in
+      use by an executor
+  */
+  Executor(Graph<S> &g,
+           std::size_t threads = std::thread::hardware_concurrency())
+      : SndBase<S>(g.block()), graph(g), nodes(0),
+        nthr(threads ? threads : 1), done(0), left(0), gen(0), parked(0),
+        quit(false), flush(false) {
+    if (!graph.compile(true))
+      return;
+    nodes = graph.size();
+    deques.reset(new Deque[nthr]);
+    for (std::size_t k = 0; k < nthr; k++) {
+      deques[k].buf.reset(new std::atomic<std::size_t>[nodes]);
+      deques[k].top = 0;
+      deques[k].bottom = 0;
+    }
+    pending.reset(new std::atomic<std::size_t>[nodes]);
+    npred.resize(nodes, 0);
+    for (std::size_t u = 0; u < nodes; u++)
+      for (auto v : graph.succ[u])
+        npred[v]++;
+    for (std::size_t v = 0; v < nodes; v++)
+      if (!npred[v])
+        roots.push_back(v);
+    scratch.resize(nthr, std::vector<span<const S>>(graph.maxin));
+    for (std::size_t k = 1; k < nthr; k++)
+      pool.emplace_back(&Executor::worker, this, k);
+  }
+
+  ~Executor() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      quit = true;
+    }
+    cv.notify_all();
+    for (auto &t : pool)
+      t.join();
+  }
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  /** Process a block \n
+      out: caller-provided output \n
+      returns out, trimmed to the graph output size
+  */
+  span<S> operator()(span<S> out) {
+    if (!nodes || !graph.ready || !graph.conc || graph.size() != nodes)
+      return out.first(0);
+    outs = out.first(graph.block());
+    for (std::size_t v = 0; v < nodes; v++)
+      pending[v].store(npred[v], std::memory_order_relaxed);
+    for (std::size_t k = 0; k < nthr; k++) {
+      deques[k].top.store(0, std::memory_order_relaxed);
+      deques[k].bottom.store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t k = 0; k < roots.size(); k++)
+      push(k % nthr, roots[k]);
+    done.store(0, std::memory_order_relaxed);
+    left.store(0, std::memory_order_relaxed);
+    flush = ftz();
+    gen.fetch_add(1);
+    if (parked.load()) {
+      std::lock_guard<std::mutex> lock(mtx);
+      cv.notify_all();
+    }
+    work(0);
+    while (left.load(std::memory_order_acquire) != nthr - 1)
+      std::this_thread::yield();
+    return outs.first(graph.nodes[graph.outp].res.size());
+  }
+
+  /** Process a block \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()() {
+    this->vsize((*this)(this->sig_span(graph.block())).size());
+    return this->vector();
+  }
+
+  /** Number of threads
+   */
+  std::size_t threads() const { return nthr; }
+};
+
+} // namespace Aurora
+
+#endif // _AURORA_EXECUTOR_
@@ -0,0 +1,361 @@
+// Expr.h
+// Lazy signal expressions
+// fused elementwise BinOp/Mix/Func chains
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_EXPR_
+#define _AURORA_EXPR_
+
+#include "SndBase.h"
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace Aurora {
+
+/* \cond */
+template <typename T> struct ident { typedef T type; };
+const std::size_t unbounded = std::numeric_limits<std::size_t>::max();
+template <typename T, typename = void> struct is_mul : std::false_type {};
+template <typename T>
+struct is_mul<T, typename std::enable_if<T::mul>::type> : std::true_type {};
+/* \endcond */
+
+/** Expression tile size \n
+    expressions are evaluated in tiles of this many samples
+*/
+const std::size_t expr_tile = 256;
+
+/** Expr class \n
+    Lazy signal expression base \n
+    S: sample type \n
+    E: derived expression type \n
+    expressions are only evaluated when assigned to an Eval object,
+    in a single pass over the whole chain, one tile at a time
+*/
+template <typename S, typename E> struct Expr {
+  /** Tile evaluation \n
+      n: first sample \n
+      t: number of samples (up to expr_tile) \n
+      buf: scratch memory for t samples \n
+      returns a pointer to t samples (buf or operand data)
+  */
+  const S *eval(std::size_t n, std::size_t t, S *buf) const {
+    return static_cast<const E &>(*this).eval(n, t, buf);
+  }
+
+  /** Expression size (shortest signal operand)
+   */
+  std::size_t size() const { return static_cast<const E &>(*this).size(); }
+
+  /** Aliasing test \n
+      p, e: memory range \n
+      returns true if a signal operand overlaps [p, e)
+  */
+  bool reads(const S *p, const S *e) const {
+    return static_cast<const E &>(*this).reads(p, e);
+  }
+};
+
+/** SigExpr class \n
+    Signal operand of an expression \n
+    S: sample type
+*/
+template <typename S> struct SigExpr : Expr<S, SigExpr<S>> {
+  span<const S> s;
+  SigExpr(span<const S> sig) : s(sig){};
+  const S *eval(std::size_t n, std::size_t t, S *buf) const {
+    (void)t;
+    (void)buf;
+    return s.data() + n;
+  }
+  std::size_t size() const { return s.size(); }
+  bool reads(const S *p, const S *e) const {
+    return s.data() < e && p < s.data() + s.size();
+  }
+};
+
+/** ValExpr class \n
+    Scalar operand of an expression \n
+    S: sample type
+*/
+template <typename S> struct ValExpr : Expr<S, ValExpr<S>> {
+  S v;
+  ValExpr(S val) : v(val){};
+  const S *eval(std::size_t n, std::size_t t, S *buf) const {
+    (void)n;
+    std::fill(buf, buf + t, v);
+    return buf;
+  }
+  std::size_t size() const { return unbounded; }
+  bool reads(const S *p, const S *e) const {
+    (void)p;
+    (void)e;
+    return false;
+  }
+};
+
+/** BinExpr class \n
+    Binary operation node, as BinOp \n
+    S: sample type \n
+    OP: binary operation function \n
+    A, B: operand expression types \n
+    plus and times use vectorised kernels, with a product
+    added to a signal fused into a single multiply-add
+*/
+template <typename S, S (*OP)(S, S), typename A, typename B>
+struct BinExpr : Expr<S, BinExpr<S, OP, A, B>> {
+  static constexpr bool vec = OP == plus<S> || OP == times<S>;
+  static constexpr bool mul = OP == times<S>;
+  A a;
+  B b;
+  BinExpr(const A &aa, const B &bb) : a(aa), b(bb){};
+
+  template <typename T>
+  static void kernel(const S *x, T y, S *o, std::size_t t) {
+    if (OP == plus<S>)
+      simd::add(x, y, o, t);
+    else
+      simd::mul(x, y, o, t);
+  }
+
+  template <typename M>
+  static void madd(const M &m, const S *c, std::size_t n, std::size_t t,
+                   S *buf) {
+    typedef typename std::decay<decltype(m.a)>::type MA;
+    typedef typename std::decay<decltype(m.b)>::type MB;
+    if constexpr (std::is_same<MB, ValExpr<S>>::value)
+      simd::muladd(m.a.eval(n, t, buf), m.b.v, c, buf, t);
+    else if constexpr (std::is_same<MA, ValExpr<S>>::value)
+      simd::muladd(m.b.eval(n, t, buf), m.a.v, c, buf, t);
+    else {
+      alignas(def_align) S tmp[expr_tile];
+      simd::muladd(m.a.eval(n, t, buf), m.b.eval(n, t, tmp), c, buf, t);
+    }
+  }
+
+  const S *eval(std::size_t n, std::size_t t, S *buf) const {
+    if constexpr (std::is_same<B, ValExpr<S>>::value) {
+      const S *x = a.eval(n, t, buf);
+      if constexpr (vec)
+        kernel(x, b.v, buf, t);
+      else
+        for (std::size_t i = 0; i < t; i++)
+          buf[i] = OP(x[i], b.v);
+    } else if constexpr (std::is_same<A, ValExpr<S>>::value) {
+      const S *y = b.eval(n, t, buf);
+      if constexpr (vec)
+        kernel(y, a.v, buf, t);
+      else
+        for (std::size_t i = 0; i < t; i++)
+          buf[i] = OP(a.v, y[i]);
+    } else if constexpr (OP == plus<S> && is_mul<A>::value) {
+      alignas(def_align) S tmp[expr_tile];
+      madd(a, b.eval(n, t, tmp), n, t, buf);
+    } else if constexpr (OP == plus<S> && is_mul<B>::value) {
+      alignas(def_align) S tmp[expr_tile];
+      madd(b, a.eval(n, t, tmp), n, t, buf);
+    } else {
+      alignas(def_align) S tmp[expr_tile];
+      const S *x = a.eval(n, t, buf);
+      const S *y = b.eval(n, t, tmp);
+      if constexpr (vec)
+        kernel(x, y, buf, t);
+      else
+        for (std::size_t i = 0; i < t; i++)
+          buf[i] = OP(x[i], y[i]);
+    }
+    return buf;
+  }
+
+  std::size_t size() const {
+    return a.size() < b.size() ? a.size() : b.size();
+  }
+
+  bool reads(const S *p, const S *e) const {
+    return a.reads(p, e) || b.reads(p, e);
+  }
+};
+
+/** FuncExpr class \n
+    Function map node, as Func \n
+    S: sample type \n
+    FN: function \n
+    A: operand expression type \n
+    rect, clip and tanha use vectorised kernels
+*/
+template <typename S, S (*FN)(S), typename A>
+struct FuncExpr : Expr<S, FuncExpr<S, FN, A>> {
+  A a;
+  FuncExpr(const A &aa) : a(aa){};
+
+  const S *eval(std::size_t n, std::size_t t, S *buf) const {
+    const S *x = a.eval(n, t, buf);
+    if constexpr (FN == rect<S>)
+      simd::abs(x, buf, t);
+    else if constexpr (FN == clip<S>)
+      simd::clip(x, (S)-1, (S)1, buf, t);
+    else if constexpr (FN == tanha<S>)
+      simd::tanh(x, buf, t);
+    else
+      for (std::size_t i = 0; i < t; i++)
+        buf[i] = FN(x[i]);
+    return buf;
+  }
+
+  std::size_t size() const { return a.size(); }
+
+  bool reads(const S *p, const S *e) const { return a.reads(p, e); }
+};
+
+/** Signal operand \n
+    s: signal \n
+    returns an expression reading s
+*/
+template <typename S> SigExpr<S> lazy(span<const S> s) { return s; }
+
+/** Signal operand \n
+    s: signal \n
+    returns an expression reading s
+*/
+template <typename S, typename Al>
+SigExpr<S> lazy(const std::vector<S, Al> &s) {
+  return span<const S>(s);
+}
+
+/* expressions only hold a view of their signals */
+template <typename S, typename Al>
+SigExpr<S> lazy(std::vector<S, Al> &&s) = delete;
+
+/** Binary operation \n
+    OP: binary operation function \n
+    a, b: operands \n
+    returns an expression computing OP(a, b)
+*/
+template <auto OP, typename S, typename A, typename B>
+BinExpr<S, OP, A, B> binop(const Expr<S, A> &a, const Expr<S, B> &b) {
+  return {static_cast<const A &>(a), static_cast<const B &>(b)};
+}
+
+/** Function map \n
+    FN: function \n
+    a: operand \n
+    returns an expression computing FN(a)
+*/
+template <auto FN, typename S, typename A>
+FuncExpr<S, FN, A> func(const Expr<S, A> &a) {
+  return FuncExpr<S, FN, A>(static_cast<const A &>(a));
+}
+
+/** Mixer \n
+    a: first operand \n
+    args: any number of other operands \n
+    returns an expression summing all operands, as Mix
+*/
+template <typename S, typename A> A mix(const Expr<S, A> &a) {
+  return static_cast<const A &>(a);
+}
+
+template <typename S, typename A, typename B, typename... Ts>
+auto mix(const Expr<S, A> &a, const Expr<S, B> &b, const Ts &... args) {
+  return mix(binop<plus<S>>(a, b), args...);
+}
+
+/* \cond */
+#define AURORA_EXPR_OPERATOR(SYM, OP)                                          \
+  template <typename S, typename A, typename B>                                \
+  BinExpr<S, OP<S>, A, B> operator SYM(const Expr<S, A> &a,                    \
+                                       const Expr<S, B> &b) {                  \
+    return {static_cast<const A &>(a), static_cast<const B &>(b)};             \
+  }                                                                            \
+  template <typename S, typename A>                                            \
+  BinExpr<S, OP<S>, A, ValExpr<S>> operator SYM(                               \
+      const Expr<S, A> &a, typename ident<S>::type v) {                        \
+    return {static_cast<const A &>(a), ValExpr<S>(v)};                         \
+  }                                                                            \
+  template <typename S, typename B>                                            \
+  BinExpr<S, OP<S>, ValExpr<S>, B> operator SYM(typename ident<S>::type v,     \
+                                                const Expr<S, B> &b) {         \
+    return {ValExpr<S>(v), static_cast<const B &>(b)};                         \
+  }
+
+AURORA_EXPR_OPERATOR(+, plus)
+AURORA_EXPR_OPERATOR(-, minus)
+AURORA_EXPR_OPERATOR(*, times)
+#undef AURORA_EXPR_OPERATOR
+/* \endcond */
+
+/** Eval class \n
+    Evaluates signal expressions into its output in a single
+    pass, one tile of expr_tile samples at a time, so that
+    intermediate results stay in cache-resident scratch memory.
+    Tiles are evaluated directly into the output, unless it is
+    also an operand of the expression (in-place processing), in
+    which case they go through scratch memory first \n
+    S: sample type
+*/
+template <typename S = float> class Eval : public SndBase<S> {
+public:
+  /** Constructor \n
+      vsize: signal vector size
+  */
+  Eval(std::size_t vsize = def_vsize) : SndBase<S>(vsize){};
+
+  /** Expression evaluation \n
+      out: caller-provided output \n
+      e: signal expression \n
+      returns out, trimmed to the expression size
+  */
+  template <typename E> span<S> operator()(span<S> out, const Expr<S, E> &e) {
+    auto &x = static_cast<const E &>(e);
+    out = out.first(x.size());
+    S *o = out.data();
+    alignas(def_align) S buf[expr_tile];
+    bool alias = x.reads(o, o + out.size());
+    for (std::size_t n = 0; n < out.size(); n += expr_tile) {
+      std::size_t t = out.size() - n < expr_tile ? out.size() - n : expr_tile;
+      const S *r = x.eval(n, t, alias ? buf : o + n);
+      if (r != o + n)
+        std::copy(r, r + t, o + n);
+    }
+    return out;
+  }
+
+  /** Expression evaluation \n
+      e: signal expression \n
+      returns reference to object signal vector
+  */
+  template <typename E>
+  const sig_vector<S> &operator()(const Expr<S, E> &e) {
+    std::size_t sz = e.size();
+    (*this)(this->sig_span(sz != unbounded ? sz : 0), e);
+    return this->vector();
+  }
+};
+
+} // namespace Aurora
+
+#endif // _AURORA_EXPR_
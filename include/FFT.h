@@ -28,6 +28,7 @@
 #ifndef _AURORA_FFT_
 #define _AURORA_FFT_
 
+#include "SndBase.h"
 #include <cmath>
 #include <complex>
 #include <vector>
@@ -66,7 +67,7 @@ static inline uint32_t np2(uint32_t n) {
     S: sample type
 */
 template <typename S = float> class FFT {
-  std::vector<std::complex<S>> c;
+  aligned_vector<std::complex<S>> c;
   bool pckd;
   std::size_t sz;
   bool norm;
@@ -132,7 +133,8 @@ public:
       r: input vector (real)
       returns pointer to complex data containing the transform
   */
-  const std::complex<S> *transform(const std::vector<S> &r) {
+  template <typename A>
+  const std::complex<S> *transform(const std::vector<S, A> &r) {
     using namespace std::complex_literals;
     const std::size_t N = sz;
     std::complex<S> wp, w = 1., even, odd;
@@ -167,7 +169,8 @@ public:
       sp - input vector (complex) \n
       returns pointer to real data containing the transform
   */
-  const S *transform(const std::vector<std::complex<S>> &sp) {
+  template <typename A>
+  const S *transform(const std::vector<std::complex<S>, A> &sp) {
     using namespace std::complex_literals;
     const std::size_t N = sz;
     std::fill(c.begin(), c.end(), std::complex<S>(0, 0));
@@ -197,17 +200,20 @@ public:
     return s;
   }
 
-  const std::vector<std::complex<S>> &operator() (const std::vector<S> &r) {
+  template <typename A>
+  const aligned_vector<std::complex<S>> &
+  operator() (const std::vector<S, A> &r) {
     transform(r);
     return c;
   }
 
-  const S *operator() (const std::vector<std::complex<S>> &sp)
+  template <typename A>
+  const S *operator() (const std::vector<std::complex<S>, A> &sp)
   {
     return transform(sp);
   }
 
-  const std::vector<std::complex<S>> &vector() const { return c; }
+  const aligned_vector<std::complex<S>> &vector() const { return c; }
   
   const S *data() const { return reinterpret_cast<const S *>(c.data()); }
   
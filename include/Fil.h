@@ -24,8 +24,8 @@
 // CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 
-#ifndef _AURORA_ONEPOLE_
-#define _AURORA_ONEPOLE_
+#ifndef _AURORA_FIL_
+#define _AURORA_FIL_
 
 #include "SndBase.h"
 #include <cmath>
@@ -117,7 +117,7 @@ template <typename S> inline void hp_cfs(S f, S bw, S fs, double *c) {
  */
 template <typename S> inline void bp_cfs(S f, S bw, S fs, double *c) {
   double w = 1. / tan(M_PI * bw / fs);
-  double cosw = 2. * cos(2 * M_PI * f / fs);
+  double cosw = 2. * std::cos(2 * M_PI * f / fs);
   c[0] = 1. / (1 + w);
   c[1] = 0;
   c[2] = -c[0];
@@ -129,7 +129,7 @@ template <typename S> inline void bp_cfs(S f, S bw, S fs, double *c) {
  */
 template <typename S> inline void br_cfs(S f, S bw, S fs, double *c) {
   double w = tan(M_PI * bw / fs);
-  double cosw = 2. * cos(2 * M_PI * f / fs);
+  double cosw = 2. * std::cos(2 * M_PI * f / fs);
   c[0] = 1 / (1 + w);
   c[1] = -cosw * c[0];
   c[2] = c[0];
@@ -150,6 +150,15 @@ class Fil : public SndBase<S> {
   S ff;
   S bbw;
   S fs;
+  Tail<S> tl;
+  Smooth<S> sm;
+
+  void decay(span<const S> out) {
+    if (tl.on() && tl.quiet(d, 4) && tl.quiet(out)) {
+      d[0] = d[1] = d[2] = d[3] = 0;
+      tl.idle(true);
+    }
+  }
 
   S filter(S s, double *c, double *d) { return FN(s, c, d); }
 
@@ -168,47 +177,190 @@ public:
       : SndBase<S>(vsize), d{0}, c{0}, ff(0), bbw(0), fs(ffs){};
 
   /** Filter \n
+     out: caller-provided output \n
      in: input \n
      f: cutoff frequency \n
-     bw: bandwidth \n;
+     bw: bandwidth \n
+     returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S f, S bw = 0) {
+  span<S> operator()(span<S> out, span<const S> in, S f, S bw = 0) {
     std::size_t n = 0;
     double *D = d, *C = c;
-    if (f != ff || bw != bbw)
-      coeffs(f, bw, fs, c);
-    auto &s = process([&]() { return filter(in[n++], C, D); }, in.size());
-    return s;
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    if ((f != ff || bw != bbw) && sm.ramp()) {
+      S f0 = ff, bw0 = bbw;
+      out = process(
+          sm, out, c,
+          [&](double t, double *cn) {
+            coeffs(sm.at(f0, f, t), sm.at(bw0, bw, t), fs, cn);
+          },
+          [&](std::size_t i, double *c) { return filter(in[i], c, D); });
+    } else {
+      if (f != ff || bw != bbw)
+        coeffs(f, bw, fs, c);
+      out = process([&]() { return filter(in[n++], C, D); }, out);
+    }
+    decay(out);
+    return out;
   }
 
   /** Filter \n
+   out: caller-provided output \n
    in: input \n
    f: cutoff frequency \n
-   bw: bandwidth \n;
+   bw: bandwidth \n
+   returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &f, S bw = 0) {
+  span<S> operator()(span<S> out, span<const S> in, span<const S> f,
+                     S bw = 0) {
     std::size_t n = 0;
     double *D = d, *C = c;
-    auto &s = process(
+    out = out.first(in.size() < f.size() ? in.size() : f.size());
+    if (tl.skip(in.first(out.size())))
+      return this->mute(out);
+    out = process(
         [&]() {
-          if (f[n] != ff)
-            coeffs(f, bw, fs, C);
+          if (f[n] != ff || bw != bbw)
+            coeffs(f[n], bw, fs, C);
           return filter(in[n++], C, D);
         },
-        in.size() < f.size() ? in.size() : f.size());
-    return s;
+        out);
+    decay(out);
+    return out;
+  }
+
+  /** Filter \n
+     in: input \n
+     f: cutoff frequency \n
+     bw: bandwidth \n;
+  */
+  const sig_vector<S> &operator()(span<const S> in, S f, S bw = 0) {
+    (*this)(this->sig_span(in.size()), in, f, bw);
+    return this->vector();
+  }
+
+  /** Filter \n
+   in: input \n
+   f: cutoff frequency \n
+   bw: bandwidth \n;
+  */
+  const sig_vector<S> &operator()(span<const S> in, span<const S> f, S bw = 0) {
+    (*this)(this->sig_span(in.size() < f.size() ? in.size() : f.size()), in, f,
+            bw);
+    return this->vector();
   }
 
+  /** Parameter smoothing \n
+      k: coefficient update period in samples (0 turns smoothing off) \n
+      ex: exponential (true) or linear (false) ramps \n
+      when on, frequency and bandwidth changes are ramped across
+      the next block by the scalar-parameter operator
+  */
+  void smooth(std::size_t k, bool ex = false) { sm.rate(k, ex); }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when the filter state and output decay to within the
+      threshold, the filter goes idle and skips processing until
+      non-silent input arrives
+  */
+  void tail(S th) { tl.threshold(th); }
+
+  /** Idle state query \n
+      returns true if the filter is idle
+  */
+  bool idle() const { return tl.idle(); }
+
   /** reset the filter \n
        fs: sampling rate
     */
   void reset(S ffs) {
     d[0] = d[1] = d[2] = d[3] = 0;
-    coeffs(ff, bbw, fs, c, d);
     fs = ffs;
+    coeffs(ff, bbw, fs, c);
+  }
+};
+
+/** FilN class  \n
+    Generic multichannel filter (first or second-order) \n
+    coefficients are computed once for all channels \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N, void (*CF)(S, S, S, double *),
+          S (*FN)(S, double *, double *)>
+class FilN : public SndBaseN<S, N> {
+  using SndBaseN<S, N>::process;
+  using SndBaseN<S, N>::minsize;
+  double d[N][4];
+  double c[5];
+  S ff;
+  S bbw;
+  S fs;
+
+  void coeffs(S f, S bw) {
+    CF(f, bw, fs, c);
+    ff = f;
+    bbw = bw;
+  }
+
+public:
+  /** Constructor \n
+   fs: sampling rate \n
+   vsize: vector size
+  */
+  FilN(S ffs = def_sr, std::size_t vsize = def_vsize)
+      : SndBaseN<S, N>(vsize), d{{0}}, c{0}, ff(0), bbw(0), fs(ffs){};
+
+  /** Filter \n
+     in: input channels \n
+     f: cutoff frequency \n
+     bw: bandwidth \n
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, S f, S bw = 0) {
+    if (f != ff || bw != bbw)
+      coeffs(f, bw);
+    return process(
+        [&](const S *x, S *y) {
+          for (std::size_t ch = 0; ch < N; ch++)
+            y[ch] = FN(x[ch], c, d[ch]);
+        },
+        in, minsize(in));
+  }
+
+  /** Filter \n
+     in: input channels \n
+     f: cutoff frequency signal (shared by all channels) \n
+     bw: bandwidth \n
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, span<const S> f,
+                            S bw = 0) {
+    std::size_t n = 0, sz = minsize(in);
+    return process(
+        [&](const S *x, S *y) {
+          if (f[n] != ff || bw != bbw)
+            coeffs(f[n], bw);
+          for (std::size_t ch = 0; ch < N; ch++)
+            y[ch] = FN(x[ch], c, d[ch]);
+          n++;
+        },
+        in, sz < f.size() ? sz : f.size());
+  }
+
+  /** reset the filter \n
+       fs: sampling rate
+    */
+  void reset(S ffs) {
+    for (auto &dd : d)
+      dd[0] = dd[1] = dd[2] = dd[3] = 0;
+    fs = ffs;
+    coeffs(ff, bbw);
   }
 };
 } // namespace Aurora
 
-#endif // _AURORA_ONEPOLE_
+#endif // _AURORA_FIL_
@@ -43,8 +43,17 @@ template <typename S = float> class FourPole : public SndBase<S> {
   double A, G[4];
   S ff;
   double piosr;
+  Tail<S> tl;
+  Smooth<S> sm;
 
-  S filter(S s, double *d, double *g, double a, S k) {
+  void decay(span<const S> out) {
+    if (tl.on() && tl.quiet(D, 4) && tl.quiet(out)) {
+      D[0] = D[1] = D[2] = D[3] = 0;
+      tl.idle(true);
+    }
+  }
+
+  S filter(S s, double *d, const double *g, double a, S k) {
     S o, u, w;
     S ss = d[3];
     for (int j = 0; j < 3; j++)
@@ -79,40 +88,110 @@ public:
       : SndBase<S>(vsize), D{0}, A(0), G{0}, ff(0), piosr(M_PI / sr){};
 
   /** Filter \n
+     out: caller-provided output \n
      in: input \n
      f: cutoff frequency \n
-     r: resonance (0-1)
+     r: resonance (0-1) \n
+     returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S f, S r) {
+  span<S> operator()(span<S> out, span<const S> in, S f, S r) {
     std::size_t n = 0;
-    if (f != ff)
-      coeffs(f, G, A, ff, piosr);
-    auto pf = [&]() { return filter(in[n++], D, G, A, r * 4); };
-    return process(pf, in.size());
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    if (f != ff && sm.ramp()) {
+      S f0 = ff;
+      double c[5] = {G[0], G[1], G[2], G[3], A};
+      out = process(
+          sm, out, c,
+          [&](double t, double *cn) {
+            coeffs(sm.at(f0, f, t), cn, cn[4], ff, piosr);
+          },
+          [&](std::size_t i, const double *c) {
+            return filter(in[i], D, c, c[4], r * 4);
+          });
+      std::copy(c, c + 4, G);
+      A = c[4];
+    } else {
+      if (f != ff)
+        coeffs(f, G, A, ff, piosr);
+      auto pf = [&]() { return filter(in[n++], D, G, A, r * 4); };
+      out = process(pf, out);
+    }
+    decay(out);
+    return out;
   }
 
   /** Filter \n
+   out: caller-provided output \n
    in: input \n
    f: cutoff frequency \n
-   r: resonance (0-1)
+   r: resonance (0-1) \n
+   returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &f, S r) {
+  span<S> operator()(span<S> out, span<const S> in, span<const S> f, S r) {
     std::size_t n = 0;
+    out = out.first(in.size() < f.size() ? in.size() : f.size());
+    if (tl.skip(in.first(out.size())))
+      return this->mute(out);
     auto pf = [&]() {
       if (f[n] != ff)
         coeffs(f[n], G, A, ff, piosr);
       return filter(in[n++], D, G, A, r * 4);
     };
-    return process(pf, in.size() < f.size() ? in.size() : f.size());
+    out = process(pf, out);
+    decay(out);
+    return out;
+  }
+
+  /** Filter \n
+     in: input \n
+     f: cutoff frequency \n
+     r: resonance (0-1)
+  */
+  const sig_vector<S> &operator()(span<const S> in, S f, S r) {
+    (*this)(this->sig_span(in.size()), in, f, r);
+    return this->vector();
   }
 
+  /** Filter \n
+   in: input \n
+   f: cutoff frequency \n
+   r: resonance (0-1)
+  */
+  const sig_vector<S> &operator()(span<const S> in, span<const S> f, S r) {
+    (*this)(this->sig_span(in.size() < f.size() ? in.size() : f.size()), in, f,
+            r);
+    return this->vector();
+  }
+
+  /** Parameter smoothing \n
+      k: coefficient update period in samples (0 turns smoothing off) \n
+      ex: exponential (true) or linear (false) ramps \n
+      when on, cutoff changes are ramped across the next block
+      by the scalar-parameter operator
+  */
+  void smooth(std::size_t k, bool ex = false) { sm.rate(k, ex); }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when the filter state and output decay to within the threshold, the
+      filter goes idle and skips processing until non-silent input
+      arrives
+  */
+  void tail(S th) { tl.threshold(th); }
+
+  /** Idle state query \n
+      returns true if the filter is idle
+  */
+  bool idle() const { return tl.idle(); }
+
   /** reset the filter \n
     fs: sampling rate
  */
   void reset(S fs) {
     piosr = M_PI / fs;
-    D[0] = D[1] = D[2] = D[3];
+    D[0] = D[1] = D[2] = D[3] = 0;
     coeffs(ff, G, A, ff, piosr);
   }
 };
@@ -29,6 +29,7 @@
 #define _AURORA_FUNC_
 
 #include "SndBase.h"
+#include <cmath>
 #include <functional>
 
 namespace Aurora {
@@ -51,15 +52,54 @@ template <typename S> inline S cosn(S ph) {
   return (S)std::cos(ph * twopi);
 }
 
+/** Fast sine function for Func \n
+    (vectorised) \n
+    S: sample type \n
+    ph: normalised phase \n
+    returns the sine of ph*2*$M_PI (see sinpoly for the accuracy)
+*/
+template <typename S> inline S fsinn(S ph) { return sinpoly(ph); }
+
+/** Fast cosine function for Func \n
+    (vectorised) \n
+    S: sample type \n
+    ph: normalised phase \n
+    returns the cosine of ph*2*$M_PI (see sinpoly for the accuracy)
+*/
+template <typename S> inline S fcosn(S ph) { return sinpoly(ph + (S).25); }
+
   
 
 /** Func class  \n
     Generic templated function maps \n
     FN: function to be applied FN(arg, table)
-    S: sample type
+    S: sample type \n
+    rect, clip, tanha, fsinn and fcosn use vectorised kernels
 */
 template <typename S, S (*FN)(S)> class Func : public SndBase<S> {
   using SndBase<S>::process;
+  static constexpr bool vec = FN == rect<S> || FN == clip<S> ||
+                              FN == tanha<S> || FN == fsinn<S> ||
+                              FN == fcosn<S>;
+
+  span<S> kernel(span<const S> in, span<S> out) {
+    rt_scope guard;
+    auto prof = this->profile();
+    this->silent(false);
+    if (FN == rect<S>)
+      simd::abs(in.data(), out.data(), out.size());
+    else if (FN == clip<S>)
+      simd::clip(in.data(), (S)-1, (S)1, out.data(), out.size());
+    else if (FN == tanha<S>)
+      simd::tanh(in.data(), out.data(), out.size());
+    else if (FN == fsinn<S>)
+      simd::sin2pi(in.data(), out.data(), out.size());
+    else {
+      simd::add(in.data(), (S).25, out.data(), out.size());
+      simd::sin2pi(out.data(), out.data(), out.size());
+    }
+    return out;
+  }
 
 public:
   /** Constructor \n
@@ -68,22 +108,45 @@ public:
   Func(std::size_t vsize = def_vsize) : SndBase<S>(vsize){};
 
   /** Functional application \n
+      out: caller-provided output \n
       in: input scalar parameter \n
-      returns reference to object signal vector
+      returns out
   */
-  const std::vector<S> &operator()(S in) {
+  span<S> operator()(span<S> out, S in) {
     auto fp = [&]() { return FN(in); };
-    return process(fp, 0);
+    return process(fp, out);
   }
 
   /** Functional application \n
+      out: caller-provided output \n
       in: input signal \n
-      returns reference to object signal vector
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in) {
+  span<S> operator()(span<S> out, span<const S> in) {
+    out = out.first(in.size());
+    if constexpr (vec)
+      return kernel(in, out);
     std::size_t n = 0;
     auto fp = [&]() { return FN(in[n++]); };
-    return process(fp, in.size());
+    return process(fp, out);
+  }
+
+  /** Functional application \n
+      in: input scalar parameter \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(S in) {
+    (*this)(this->sig_span(0), in);
+    return this->vector();
+  }
+
+  /** Functional application \n
+      in: input signal \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> in) {
+    (*this)(this->sig_span(in.size()), in);
+    return this->vector();
   }
 };
 
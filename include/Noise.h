@@ -66,17 +66,38 @@ class Noise : public SndBase<S> {
  Noise(S sr = def_sr,std::size_t vsize = def_vsize) 
   : SndBase<S>(vsize), fs(sr), incr(0), ov(0), t(0) { }
 
-  const std::vector<S> & operator()(S a, S f, bool interp = false) {
+  /** Noise \n
+      out: caller-provided output \n
+      a: amplitude \n
+      f: sample-and-hold frequency \n
+      interp: interpolation flag \n
+      returns out
+  */
+  span<S> operator()(span<S> out, S a, S f, bool interp = false) {
     std::size_t pp = fs/(f > 0 ? f : 0.000001);
     return process([&]() {
 	return sample(a, pp, interp);
-	}, 0);
+	}, out);
   }
 
-  const std::vector<S> & operator()(S a) {
-    std::size_t tt = t;
+  /** Noise \n
+      out: caller-provided output \n
+      a: amplitude \n
+      returns out
+  */
+  span<S> operator()(span<S> out, S a) {
     return process([&]() {
-	return sample(a,0,0); }, 0);
+	return sample(a,0,0); }, out);
+  }
+
+  const sig_vector<S> & operator()(S a, S f, bool interp = false) {
+    (*this)(this->sig_span(0), a, f, interp);
+    return this->vector();
+  }
+
+  const sig_vector<S> & operator()(S a) {
+    (*this)(this->sig_span(0), a);
+    return this->vector();
   }
 
 };
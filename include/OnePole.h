@@ -42,6 +42,15 @@ template <typename S = float> class OnePole : public SndBase<S> {
   double A, G;
   S ff;
   double piosr;
+  Tail<S> tl;
+  Smooth<S> sm;
+
+  void decay(span<const S> out) {
+    if (tl.on() && tl.quiet(&D, 1) && tl.quiet(out)) {
+      D = 0;
+      tl.idle(true);
+    }
+  }
 
   S filter(S s, double &d, double g, double a) {
     S u = g * s;
@@ -66,38 +75,103 @@ public:
       : SndBase<S>(vsize), D(0), A(0), G(0), ff(0), piosr(M_PI / fs){};
 
   /** Filter \n
+     out: caller-provided output \n
      in: input \n
      f: cutoff frequency \n
+     returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S f) {
+  span<S> operator()(span<S> out, span<const S> in, S f) {
     double d = D;
     std::size_t n = 0;
-    if (f != ff)
-      coeffs(f, G, A, ff, piosr);
-    auto &s = process([&]() { return filter(in[n++], d, G, A); }, in.size());
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    if (f != ff && sm.ramp()) {
+      S f0 = ff;
+      double c[2] = {G, A};
+      out = process(
+          sm, out, c,
+          [&](double t, double *cn) {
+            coeffs(sm.at(f0, f, t), cn[0], cn[1], ff, piosr);
+          },
+          [&](std::size_t i, const double *c) {
+            return filter(in[i], d, c[0], c[1]);
+          });
+      G = c[0];
+      A = c[1];
+    } else {
+      if (f != ff)
+        coeffs(f, G, A, ff, piosr);
+      out = process([&]() { return filter(in[n++], d, G, A); }, out);
+    }
     D = d;
-    return s;
+    decay(out);
+    return out;
   }
 
   /** Filter \n
+   out: caller-provided output \n
    in: input \n
    f: cutoff frequency \n
+   returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &f) {
+  span<S> operator()(span<S> out, span<const S> in, span<const S> f) {
     double d = D;
     std::size_t n = 0;
-    auto &s = process(
+    out = out.first(in.size() < f.size() ? in.size() : f.size());
+    if (tl.skip(in.first(out.size())))
+      return this->mute(out);
+    out = process(
         [&]() {
           if (f[n] != ff)
             coeffs(f[n], G, A, ff, piosr);
           return filter(in[n++], d, G, A);
         },
-        in.size() < f.size() ? in.size() : f.size());
+        out);
     D = d;
-    return s;
+    decay(out);
+    return out;
+  }
+
+  /** Filter \n
+     in: input \n
+     f: cutoff frequency \n
+  */
+  const sig_vector<S> &operator()(span<const S> in, S f) {
+    (*this)(this->sig_span(in.size()), in, f);
+    return this->vector();
+  }
+
+  /** Filter \n
+   in: input \n
+   f: cutoff frequency \n
+  */
+  const sig_vector<S> &operator()(span<const S> in, span<const S> f) {
+    (*this)(this->sig_span(in.size() < f.size() ? in.size() : f.size()), in, f);
+    return this->vector();
   }
 
+  /** Parameter smoothing \n
+      k: coefficient update period in samples (0 turns smoothing off) \n
+      ex: exponential (true) or linear (false) ramps \n
+      when on, cutoff changes are ramped across the next block
+      by the scalar-parameter operators
+  */
+  void smooth(std::size_t k, bool ex = false) { sm.rate(k, ex); }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when the filter state and output decay to within the
+      threshold, the filter goes idle and skips processing until
+      non-silent input arrives
+  */
+  void tail(S th) { tl.threshold(th); }
+
+  /** Idle state query \n
+      returns true if the filter is idle
+  */
+  bool idle() const { return tl.idle(); }
+
   /** reset the filter \n
        fs: sampling rate
     */
@@ -107,6 +181,91 @@ public:
     coeffs(ff, G, A, ff, piosr);
   }
 };
+
+/** OnePoleN class  \n
+    Multichannel first-order lowpass filter \n
+    coefficients are computed once and channels
+    are processed as parallel lanes \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N> class OnePoleN : public SndBaseN<S, N> {
+  using SndBaseN<S, N>::process;
+  using SndBaseN<S, N>::minsize;
+  double D[N];
+  double A, G;
+  S ff;
+  double piosr;
+
+  void filter(const S *x, S *y, double *d) {
+    for (std::size_t c = 0; c < N; c++) {
+      S u = G * x[c];
+      y[c] = u + d[c];
+      d[c] = u - A * y[c];
+    }
+  }
+
+  void coeffs(S f) {
+    S w = std::tan(f * piosr);
+    G = w / (1 + w);
+    A = (w - 1) / (1 + w);
+    ff = f;
+  }
+
+public:
+  /** Constructor \n
+   fs: sampling rate \n
+   vsize: vector size
+  */
+  OnePoleN(S fs = def_sr, std::size_t vsize = def_vsize)
+      : SndBaseN<S, N>(vsize), D{0}, A(0), G(0), ff(0), piosr(M_PI / fs){};
+
+  /** Filter \n
+     in: input channels \n
+     f: cutoff frequency \n
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, S f) {
+    double d[N];
+    std::copy(D, D + N, d);
+    if (f != ff)
+      coeffs(f);
+    auto o = process([&](const S *x, S *y) { filter(x, y, d); }, in,
+                     minsize(in));
+    std::copy(d, d + N, D);
+    return o;
+  }
+
+  /** Filter \n
+   in: input channels \n
+   f: cutoff frequency signal (shared by all channels) \n
+   returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, span<const S> f) {
+    double d[N];
+    std::size_t n = 0, sz = minsize(in);
+    std::copy(D, D + N, d);
+    auto o = process(
+        [&](const S *x, S *y) {
+          if (f[n] != ff)
+            coeffs(f[n]);
+          filter(x, y, d);
+          n++;
+        },
+        in, sz < f.size() ? sz : f.size());
+    std::copy(d, d + N, D);
+    return o;
+  }
+
+  /** reset the filter \n
+       fs: sampling rate
+    */
+  void reset(S fs) {
+    std::fill(D, D + N, 0);
+    piosr = M_PI / fs;
+    coeffs(ff);
+  }
+};
 } // namespace Aurora
 
 #endif // _AURORA_ONEPOLE_
@@ -29,6 +29,7 @@
 #define _AURORA_OSC_
 
 #include "SndBase.h"
+#include "Table.h"
 #include <cmath>
 #include <functional>
 
@@ -45,6 +46,16 @@ template <typename S> inline S lookup(double ph, const std::vector<S> *t) {
   return (*t)[(std::size_t)(ph * t->size())];
 }
 
+/** Truncating guarded table lookup function \n
+    S: sample type \n
+    ph: phase \n
+    t: function table  \n
+    returns a sample
+*/
+template <typename S> inline S lookup(double ph, const Table<S> *t) {
+  return (*t)[(std::size_t)(ph * t->size())];
+}
+
 /** Linear interp table lookup function for Osc \n
     S: sample type \n
     ph: phase  \mn
@@ -65,6 +76,95 @@ template <typename S> S inline lookupc(double ph, const std::vector<S> *t) {
   return cubic_interp(ph * t->size(), *t);
 }
 
+/** Linear interp guarded table lookup function \n
+    S: sample type \n
+    ph: phase  \n
+    t: function table  \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookupi(double ph, const Table<S> *t) {
+  return t->linear(ph * t->size());
+}
+
+/** Cubic interp guarded table lookup function \n
+    S: sample type \n
+    ph: phase  \n
+    t: function table  \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookupc(double ph, const Table<S> *t) {
+  return t->cubic(ph * t->size());
+}
+
+/** Hermite interp guarded table lookup function \n
+    S: sample type \n
+    ph: phase  \n
+    t: function table  \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookuph(double ph, const Table<S> *t) {
+  return t->hermite(ph * t->size());
+}
+
+/** Truncating table lookup function for FixOsc \n
+    S: sample type \n
+    t: guarded table data \n
+    k: table index \n
+    f: fractional part of the index (unused) \n
+    returns a sample
+*/
+template <typename S> inline S lookup(const S *t, uint32_t k, S f) {
+  (void)f;
+  return t[k];
+}
+
+/** Linear interp table lookup function for FixOsc \n
+    S: sample type \n
+    t: guarded table data \n
+    k: table index \n
+    f: fractional part of the index \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookupi(const S *t, uint32_t k, S f) {
+  const S *p = t + k;
+  return p[0] + f * (p[1] - p[0]);
+}
+
+/** Cubic interp table lookup function for FixOsc \n
+    S: sample type \n
+    t: guarded table data \n
+    k: table index \n
+    f: fractional part of the index \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookupc(const S *t, uint32_t k, S f) {
+  const S *p = t + k;
+  S a = p[-1], b = p[0], c = p[1], d = p[2];
+  S e = d + 3 * b;
+  return (((e - a - 3 * c) / 6 * f + (a + c) / 2 - b) * f + c -
+          (2 * a + e) / 6) *
+             f +
+         b;
+}
+
+/** Hermite interp table lookup function for FixOsc \n
+    S: sample type \n
+    t: guarded table data \n
+    k: table index \n
+    f: fractional part of the index \n
+    returns an interpolated sample
+*/
+template <typename S> inline S lookuph(const S *t, uint32_t k, S f) {
+  const S *p = t + k;
+  S a = p[-1], b = p[0], c = p[1], d = p[2];
+  return ((((d - a) / 2 + (S)1.5 * (b - c)) * f + a - (S)2.5 * b + 2 * c -
+           d / 2) *
+              f +
+          (c - a) / 2) *
+             f +
+         b;
+}
+
 /** Sine function for Osc \n
     S: sample type \n
     ph: normalised phase  \n
@@ -85,6 +185,45 @@ template <typename S> inline S cos(double ph, const std::vector<S> *t = 0) {
   return (S)std::cos(ph * twopi);
 }
 
+/** Fast sine function for Osc \n
+    S: sample type \n
+    Q: accuracy (see sinpoly) \n
+    ph: normalised phase  \n
+    returns the sine of ph*2*$M_PI (vectorised in OscBank)
+*/
+template <typename S, sin_quality Q = SIN_MEDIUM>
+inline S fsin(double ph, const std::vector<S> *t = 0) {
+  (void)t;
+  return sinpoly((S)ph, Q);
+}
+
+/** Fast cosine function for Osc \n
+    S: sample type \n
+    Q: accuracy (see sinpoly) \n
+    ph: normalised phase \n
+    returns the cosine of ph*2*$M_PI (vectorised in OscBank)
+*/
+template <typename S, sin_quality Q = SIN_MEDIUM>
+inline S fcos(double ph, const std::vector<S> *t = 0) {
+  (void)t;
+  return sinpoly((S)(ph + .25), Q);
+}
+
+/* \cond */
+/* accuracy + 1 of fsin (positive) or fcos (negative), 0 for
+   other functions */
+template <typename S, S (*FN)(double, const std::vector<S> *)>
+constexpr int fast_sin() {
+  return FN == fsin<S, SIN_FAST>     ? 1
+         : FN == fsin<S, SIN_MEDIUM> ? 2
+         : FN == fsin<S, SIN_BEST>   ? 3
+         : FN == fcos<S, SIN_FAST>   ? -1
+         : FN == fcos<S, SIN_MEDIUM> ? -2
+         : FN == fcos<S, SIN_BEST>   ? -3
+                                     : 0;
+}
+/* \endcond */
+
 /** Phase function for Osc \n
     S: sample type \n
     ph: normalised phase \n
@@ -95,174 +234,723 @@ template <typename S> inline S phase(double ph, const std::vector<S> *t = 0) {
   return (S)ph;
 }
 
-/** Osc class  \n
-    Generic oscillator \n
+/** OscBase class  \n
+    Oscillator interface, shared by Osc, FixOsc and BlOsc \n
     S: sample type \n
-    FN: oscillator function
+    D: derived class, providing synth(a, f, phs, pm), which computes
+    a sample and advances the phase, and optionally reset_obj(fs) and
+    to_phase(phs) \n
+    P: phase accumulator type \n
+    synth() is resolved at compile time, so that it is inlined into
+    the processing loop of each operator() overload. It is not
+    virtual, so the oscillators built on OscBase are final: a new
+    oscillator derives from OscBase<S, D> itself.
 */
-template <typename S = float, S (*FN)(double, const std::vector<S> *) = cos>
-class Osc : public SndBase<S> {
+template <typename S, typename D, typename P = double>
+class OscBase : public SndBase<S> {
   using SndBase<S>::process;
 
+  D &self() {
+    static_assert(std::is_base_of<OscBase, D>::value,
+                  "D must derive from OscBase<S, D, P>");
+    return static_cast<D &>(*this);
+  }
+
 protected:
-  double ph;
+  P ph;
   S ts;
-  const std::vector<S> *tab;
 
-  virtual S synth(S a, S f, double &phs, const std::vector<S> *t, S pm = 0) {
+  template <typename T, S (*F)(double, const T *)>
+  S step(S a, S f, double &phs, const T *t, S pm) {
     phs += pm;
     while (phs < 0)
       phs += 1.;
     while (phs >= 1.)
       phs -= 1.;
-    S s = (S)(a * FN(phs, t));
+    S s = (S)(a * F(phs, t));
     phs = f * ts + phs - pm;
     return s;
   }
 
-  virtual void reset_obj(S fs) {
+  void reset_obj(S fs) {
     ts = 1 / fs;
-    ph = 0.;
+    ph = 0;
   }
 
-public:
-  /** Constructor \n
-      t: function table
-      f: oscillator function \n
-      fs: sampling rate \n
-      vsize: signal vector size
-  */
-  Osc(const std::vector<S> *t, S fs = (S)def_sr, std::size_t vsize = def_vsize)
-      : SndBase<S>(vsize), ph(0.), ts(1 / fs), tab(t){};
-
-  /** Constructor \n
-    fs: sampling rate \n
-    vsize: signal vector size
-*/
-  Osc(S fs = (S)def_sr, std::size_t vsize = def_vsize)
-      : Osc(nullptr, fs, vsize){};
+  static P to_phase(double phs) { return phs; }
 
-  virtual ~Osc(){};
+  OscBase(S fs, std::size_t vsize) : SndBase<S>(vsize), ph(0), ts(1 / fs){};
 
+public:
   /** Sampling rate query \n
       returns sampling rate
   */
   S fs() const { return 1 / ts; }
 
   /** Oscillator \n
+      out: caller-provided output \n
       a: scalar amplitude \n
       f: scalar frequency \n
       pm: scalar phase \n
-      returns reference to object signal vector
+      returns out
   */
-  const std::vector<S> &operator()(S a, S f, S pm = 0) {
-    double phs = ph;
-    auto &s = process([&]() { return synth(a, f, phs, tab, pm); }, 0);
+  span<S> operator()(span<S> out, S a, S f, S pm = 0) {
+    P phs = ph;
+    process([&]() { return self().synth(a, f, phs, pm); }, out);
     ph = phs;
-    return s;
+    return out;
   }
 
   /** Oscillator \n
+      out: caller-provided output \n
       a: scalar amplitude \n
       fm: frequency signal \n
       pm: scalar phase \n
-      returns reference to object signal vector
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(S a, const std::vector<S> &fm, S pm = 0) {
-    double phs = ph;
+  span<S> operator()(span<S> out, S a, span<const S> fm, S pm = 0) {
+    P phs = ph;
     std::size_t n = 0;
-    auto &s =
-        process([&]() { return synth(a, fm[n++], phs, tab, pm); }, fm.size());
+    out = process([&]() { return self().synth(a, fm[n++], phs, pm); },
+                  out.first(fm.size()));
     ph = phs;
-    return s;
+    return out;
   }
 
   /** Oscillator \n
+      out: caller-provided output \n
       am: amplitude signal \n
       f: scalar frequency \n
       pm: scalar phase \n
-      returns reference to object signal vector
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &am, S f, S pm = 0) {
-    double phs = ph;
+  span<S> operator()(span<S> out, span<const S> am, S f, S pm = 0) {
+    P phs = ph;
     std::size_t n = 0;
-    auto &s =
-        process([&]() { return synth(am[n++], f, phs, tab, pm); }, am.size());
+    out = process([&]() { return self().synth(am[n++], f, phs, pm); },
+                  out.first(am.size()));
     ph = phs;
-    return s;
+    return out;
   }
 
   /** Oscillator \n
+      out: caller-provided output \n
       am: amplitude signal \n
       fm: frequency signal \n
       pm: scalar phase \n
-      returns reference to object signal vector
+      returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &am,
-                                   const std::vector<S> &fm, S pm = 0) {
-    double phs = ph;
+  span<S> operator()(span<S> out, span<const S> am, span<const S> fm,
+                     S pm = 0) {
+    P phs = ph;
     std::size_t n = 0;
-    auto &s = process(
+    out = process(
         [&]() {
-          auto s = synth(am[n], fm[n], phs, tab, pm);
+          auto s = self().synth(am[n], fm[n], phs, pm);
           n++;
           return s;
         },
-        am.size() < fm.size() ? am.size() : fm.size());
+        out.first(am.size() < fm.size() ? am.size() : fm.size()));
     ph = phs;
-    return s;
+    return out;
   }
 
   /** Oscillator \n
-    a: scalar amplitude \n
-    f:  scalar frequency  \n
-    pm: phase modulation signal \n
-    returns reference to object signal vector
- */
-  const std::vector<S> &operator()(S a, S f, const std::vector<S> &pm) {
-    double phs = ph;
+      out: caller-provided output \n
+      a: scalar amplitude \n
+      f:  scalar frequency  \n
+      pm: phase modulation signal \n
+      returns out, trimmed to the input size
+  */
+  span<S> operator()(span<S> out, S a, S f, span<const S> pm) {
+    P phs = ph;
     std::size_t n = 0;
-    auto &s =
-        process([&]() { return synth(a, f, phs, tab, pm[n++]); }, pm.size());
+    out = process([&]() { return self().synth(a, f, phs, pm[n++]); },
+                  out.first(pm.size()));
     ph = phs;
-    return s;
+    return out;
   }
 
   /** Oscillator \n
+      out: caller-provided output \n
       am: amplitude signal \n
       f:  scalar frequency  \n
       pm: phase modulation signal \n
-      returns reference to object signal vector
+      returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &am, S f,
-                                   const std::vector<S> &pm) {
-    double phs = ph;
+  span<S> operator()(span<S> out, span<const S> am, S f, span<const S> pm) {
+    P phs = ph;
     std::size_t n = 0;
-    auto &s = process(
+    out = process(
         [&]() {
-          auto s = synth(am[n], f, phs, tab, pm[n]);
+          auto s = self().synth(am[n], f, phs, pm[n]);
           n++;
           return s;
         },
-        am.size() < pm.size() ? am.size() : pm.size());
+        out.first(am.size() < pm.size() ? am.size() : pm.size()));
     ph = phs;
-    return s;
+    return out;
+  }
+
+  /** Oscillator \n
+      a: scalar amplitude \n
+      f: scalar frequency \n
+      pm: scalar phase \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(S a, S f, S pm = 0) {
+    (*this)(this->sig_span(0), a, f, pm);
+    return this->vector();
+  }
+
+  /** Oscillator \n
+      a: scalar amplitude \n
+      fm: frequency signal \n
+      pm: scalar phase \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(S a, span<const S> fm, S pm = 0) {
+    (*this)(this->sig_span(fm.size()), a, fm, pm);
+    return this->vector();
+  }
+
+  /** Oscillator \n
+      am: amplitude signal \n
+      f: scalar frequency \n
+      pm: scalar phase \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> am, S f, S pm = 0) {
+    (*this)(this->sig_span(am.size()), am, f, pm);
+    return this->vector();
+  }
+
+  /** Oscillator \n
+      am: amplitude signal \n
+      fm: frequency signal \n
+      pm: scalar phase \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> am, span<const S> fm,
+                                  S pm = 0) {
+    (*this)(this->sig_span(am.size() < fm.size() ? am.size() : fm.size()), am,
+            fm, pm);
+    return this->vector();
+  }
+
+  /** Oscillator \n
+    a: scalar amplitude \n
+    f:  scalar frequency  \n
+    pm: phase modulation signal \n
+    returns reference to object signal vector
+ */
+  const sig_vector<S> &operator()(S a, S f, span<const S> pm) {
+    (*this)(this->sig_span(pm.size()), a, f, pm);
+    return this->vector();
+  }
+
+  /** Oscillator \n
+      am: amplitude signal \n
+      f:  scalar frequency  \n
+      pm: phase modulation signal \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> am, S f, span<const S> pm) {
+    (*this)(this->sig_span(am.size() < pm.size() ? am.size() : pm.size()), am,
+            f, pm);
+    return this->vector();
   }
 
+  /** set the internal oscillator phase \n
+      phs: phase
+  */
+  void phase(double phs) { ph = D::to_phase(phs); }
+
+  /** reset the oscillator \n
+      fs: sampling rate
+   */
+  void reset(S fs) { self().reset_obj(fs); }
+};
+
+/** Osc class  \n
+    Generic oscillator \n
+    S: sample type \n
+    FN: oscillator function
+*/
+template <typename S = float, S (*FN)(double, const std::vector<S> *) = cos>
+class Osc final : public OscBase<S, Osc<S, FN>> {
+  friend OscBase<S, Osc>;
+  const std::vector<S> *tab;
+
+  S synth(S a, S f, double &phs, S pm) {
+    return this->template step<std::vector<S>, FN>(a, f, phs, tab, pm);
+  }
+
+public:
+  /** Constructor \n
+      t: function table
+      f: oscillator function \n
+      fs: sampling rate \n
+      vsize: signal vector size
+  */
+  Osc(const std::vector<S> *t, S fs = (S)def_sr, std::size_t vsize = def_vsize)
+      : OscBase<S, Osc>(fs, vsize), tab(t){};
+
+  /** Constructor \n
+    fs: sampling rate \n
+    vsize: signal vector size
+*/
+  Osc(S fs = (S)def_sr, std::size_t vsize = def_vsize)
+      : Osc(nullptr, fs, vsize){};
+
   /** set the Osc function table \n
      t: function table
  */
   void table(const std::vector<S> *t) { tab = t; }
+};
 
-  /** set the internal oscillator phase \n
-      phs: phase
+/** FixOsc class  \n
+    Fixed-point phase table oscillator \n
+    S: sample type \n
+    FN: table lookup function (lookup, lookupi, lookupc or lookuph) \n
+    The phase is kept in a 32-bit unsigned accumulator holding a
+    whole cycle, so that it wraps around by integer overflow. The top
+    bits of the phase give the table index and the bits below them
+    the fractional part, extracted with a shift and a mask. Tables
+    are Table objects, whose size must be a power of two (other
+    sizes are rejected, see table()). Phase increments are rounded
+    to the nearest 2^-32 of a cycle, a frequency resolution of
+    fs / 2^32. Frequency increments and phase offsets are only
+    converted when they change, that is, once per block when they
+    are scalars.
+*/
+template <typename S = float, S (*FN)(const S *, uint32_t, S) = lookupi>
+class FixOsc final : public OscBase<S, FixOsc<S, FN>, uint32_t> {
+  friend OscBase<S, FixOsc, uint32_t>;
+  const S *tab;
+  int sh;
+  uint32_t msk;
+  S fsc;
+  S lf, lpm;
+  uint32_t inc, pinc;
+
+  static uint32_t to_phase(double phs) {
+    return (uint32_t)std::llround(phs * 4294967296.);
+  }
+
+  /* silent table, used until a valid one is set */
+  static const Table<S> &none() {
+    static const Table<S> t(2);
+    return t;
+  }
+
+  void bits(std::size_t len) {
+    int k = 1;
+    while (k < 31 && ((std::size_t)2 << k) <= len)
+      k++;
+    sh = 32 - k;
+    msk = (1u << sh) - 1;
+    fsc = (S)1 / (S)(msk + 1.);
+  }
+
+  S synth(S a, S f, uint32_t &phs, S pm) {
+    if (f != lf) {
+      lf = f;
+      inc = to_phase((double)f * this->ts);
+    }
+    if (pm != lpm) {
+      lpm = pm;
+      pinc = to_phase(pm);
+    }
+    uint32_t p = phs + pinc;
+    S s = a * FN(tab, p >> sh, (int32_t)(p & msk) * fsc);
+    phs += inc;
+    return s;
+  }
+
+  void reset_obj(S fs) {
+    OscBase<S, FixOsc, uint32_t>::reset_obj(fs);
+    lf = lpm = 0;
+    inc = pinc = 0;
+  }
+
+public:
+  /** Constructor \n
+      t: function table (size 2^k, 1 <= k <= 31; the oscillator
+      outputs silence until a valid table is set) \n
+      fs: sampling rate \n
+      vsize: signal vector size
+  */
+  FixOsc(const Table<S> *t, S fs = (S)def_sr, std::size_t vsize = def_vsize)
+      : OscBase<S, FixOsc, uint32_t>(fs, vsize), lf(0), lpm(0), inc(0),
+        pinc(0) {
+    if (!table(t))
+      table(&none());
+  };
+
+  /** set the FixOsc function table \n
+     t: function table (size 2^k, 1 <= k <= 31) \n
+     returns false, leaving the table unchanged, if t is null or
+     its size is not a power of two
+  */
+  bool table(const Table<S> *t) {
+    std::size_t n = t ? t->size() : 0;
+    if (n < 2 || n > ((std::size_t)1 << 31) || (n & (n - 1)))
+      return false;
+    tab = t->data();
+    bits(n);
+    return true;
+  }
+};
+
+/** QuadOsc class  \n
+    Recursive quadrature sinusoidal oscillator \n
+    S: sample type \n
+    a unit phasor is rotated by a complex multiplication every
+    sample (in double precision) and renormalised at the end of each
+    block, producing a sine and its quadrature cosine. The frequency
+    is fixed across a block (use Osc with fsin or fcos for frequency
+    modulation). In double precision, the max abs error is under
+    1e-14 after ten minutes at 44.1 kHz (see bench/sine.cpp).
+*/
+template <typename S = float> class QuadOsc : public SndBase<S> {
+  using SndBase<S>::process;
+  double re, im;
+  double cw, sw;
+  S ff;
+  S ts;
+
+  void freq(S f) {
+    if (f != ff) {
+      cw = std::cos(twopi * f * ts);
+      sw = std::sin(twopi * f * ts);
+      ff = f;
+    }
+  }
+
+  void norm() {
+    double g = 1 / std::sqrt(re * re + im * im);
+    re *= g;
+    im *= g;
+  }
+
+public:
+  /** Constructor \n
+      fs: sampling rate \n
+      vsize: signal vector size
+  */
+  QuadOsc(S fs = (S)def_sr, std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), re(1.), im(0.), cw(1.), sw(0.), ff(0),
+        ts(1 / fs){};
+
+  /** Sampling rate query \n
+      returns sampling rate
   */
-  void phase(double phs) { ph = phs; }
+  S fs() const { return 1 / ts; }
+
+  /** Oscillator (sine) \n
+      out: caller-provided output \n
+      a: amplitude \n
+      f: frequency \n
+      returns out
+  */
+  span<S> operator()(span<S> out, S a, S f) {
+    double x = re, y = im;
+    freq(f);
+    process(
+        [&]() {
+          S s = (S)(a * y);
+          double t = x * cw - y * sw;
+          y = y * cw + x * sw;
+          x = t;
+          return s;
+        },
+        out);
+    re = x;
+    im = y;
+    norm();
+    return out;
+  }
+
+  /** Quadrature oscillator \n
+      out: caller-provided output (sine) \n
+      qout: caller-provided output (cosine) \n
+      a: amplitude \n
+      f: frequency \n
+      returns out, trimmed to the size of qout
+  */
+  span<S> operator()(span<S> out, span<S> qout, S a, S f) {
+    double x = re, y = im;
+    std::size_t n = 0;
+    freq(f);
+    out = process(
+        [&]() {
+          S s = (S)(a * y);
+          qout[n++] = (S)(a * x);
+          double t = x * cw - y * sw;
+          y = y * cw + x * sw;
+          x = t;
+          return s;
+        },
+        out.first(qout.size()));
+    re = x;
+    im = y;
+    norm();
+    return out;
+  }
+
+  /** Oscillator (sine) \n
+      a: amplitude \n
+      f: frequency \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(S a, S f) {
+    (*this)(this->sig_span(0), a, f);
+    return this->vector();
+  }
+
+  /** set the oscillator phase \n
+      phs: phase (in cycles)
+  */
+  void phase(double phs) {
+    re = std::cos(twopi * phs);
+    im = std::sin(twopi * phs);
+  }
 
   /** reset the oscillator \n
       fs: sampling rate
    */
-  void reset(S fs) { reset_obj(fs); }
+  void reset(S fs) {
+    ts = 1 / fs;
+    ff = 0;
+    cw = 1.;
+    sw = 0.;
+    phase(0);
+  }
+};
+
+/** OscBank class  \n
+    Bank of oscillators, held in structure-of-arrays form \n
+    S: sample type \n
+    FN: oscillator function \n
+    phases, amplitudes and frequencies of all oscillators are
+    kept in contiguous arrays, padded to a whole number of lanes,
+    and all oscillators are advanced together once per sample, with
+    their outputs summed lane by lane. With fsin and fcos, the
+    function is computed by a vector kernel across the
+    oscillators. Each oscillator produces the same output as a
+    single Osc (for frequencies below the sampling rate), with a
+    single loop over all of them. The gain over
+    separate Osc objects comes from fsin and fcos, and for float
+    from table lookups; with library functions such as sin and
+    cos, called per oscillator in either case, and with double
+    lookups, the bank runs at about the speed of separate Oscs.
+*/
+template <typename S = float, S (*FN)(double, const std::vector<S> *) = cos>
+class OscBank : public SndBase<S> {
+  static constexpr std::size_t lanes =
+      def_align / sizeof(S) ? def_align / sizeof(S) : 1;
+  static constexpr int fsn = fast_sin<S, FN>();
+  static constexpr sin_quality fsq = (sin_quality)((fsn < 0 ? -fsn : fsn) - 1);
+  static constexpr double fso = fsn < 0 ? .25 : 0.;
+  std::size_t nos;
+  aligned_vector<double> ph;
+  aligned_vector<S> am;
+  aligned_vector<S> fr;
+  aligned_vector<S> inc;
+  aligned_vector<S> row;
+  S ts;
+  const std::vector<S> *tab;
+
+  static std::size_t padded(std::size_t n) {
+    return (n + lanes - 1) / lanes * lanes;
+  }
+
+public:
+  /** Constructor \n
+      t: function table \n
+      n: number of oscillators \n
+      fs: sampling rate \n
+      vsize: signal vector size
+  */
+  OscBank(const std::vector<S> *t, std::size_t n, S fs = (S)def_sr,
+          std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), nos(n), ph(padded(n)), am(padded(n)),
+        fr(padded(n)), inc(padded(n)), row(padded(n)), ts(1 / fs),
+        tab(t){};
+
+  /** Constructor \n
+      n: number of oscillators \n
+      fs: sampling rate \n
+      vsize: signal vector size
+  */
+  OscBank(std::size_t n, S fs = (S)def_sr, std::size_t vsize = def_vsize)
+      : OscBank(nullptr, n, fs, vsize){};
+
+  /** Number of oscillators
+   */
+  std::size_t size() const { return nos; }
+
+  /** Sampling rate query \n
+      returns sampling rate
+  */
+  S fs() const { return 1 / ts; }
+
+  /** Set an oscillator amplitude \n
+      k: oscillator \n
+      a: amplitude
+  */
+  void amp(std::size_t k, S a) {
+    if (k < nos)
+      am[k] = a;
+  }
+
+  /** Set an oscillator frequency \n
+      k: oscillator \n
+      f: frequency
+  */
+  void freq(std::size_t k, S f) {
+    if (k < nos)
+      inc[k] = (fr[k] = f) * ts;
+  }
+
+  /** Set an oscillator phase \n
+      k: oscillator \n
+      phs: phase
+  */
+  void phase(std::size_t k, double phs) {
+    if (k < nos)
+      ph[k] = phs;
+  }
+
+  /** Set all oscillator amplitudes and frequencies \n
+      a: amplitudes \n
+      f: frequencies
+  */
+  void params(span<const S> a, span<const S> f) {
+    for (std::size_t k = 0; k < nos && k < a.size(); k++)
+      am[k] = a[k];
+    for (std::size_t k = 0; k < nos && k < f.size(); k++)
+      inc[k] = (fr[k] = f[k]) * ts;
+  }
+
+  /** Oscillator bank, summed output \n
+      out: caller-provided output \n
+      returns out
+  */
+  span<S> operator()(span<S> out) {
+    rt_scope guard;
+    auto prof = this->profile();
+    std::size_t n = ph.size();
+    double *p = ph.data();
+    const S *a = am.data(), *d = inc.data();
+    S *y = row.data();
+    for (auto &s : out) {
+      alignas(def_align) S acc[lanes] = {0};
+      if constexpr (fsn != 0) {
+        for (std::size_t k = 0; k < n; k++) {
+          double q = p[k];
+          q = q >= 1. ? q - 1. : q;
+          q = q < 0. ? q + 1. : q;
+          y[k] = (S)(q + fso);
+          p[k] = d[k] + q;
+        }
+        simd::sin2pi(y, y, n, fsq);
+        simd::mul(y, a, y, n);
+      } else
+        for (std::size_t k = 0; k < n; k++) {
+          double q = p[k];
+          q = q >= 1. ? q - 1. : q;
+          q = q < 0. ? q + 1. : q;
+          y[k] = (S)(a[k] * FN(q, tab));
+          p[k] = d[k] + q;
+        }
+      for (std::size_t k = 0; k < n; k += lanes)
+        for (std::size_t j = 0; j < lanes; j++)
+          acc[j] += y[k + j];
+      s = 0;
+      for (std::size_t j = 0; j < lanes; j++)
+        s += acc[j];
+    }
+    return out;
+  }
+
+  /** Oscillator bank, summed output \n
+      out: caller-provided output \n
+      a: amplitudes \n
+      f: frequencies \n
+      returns out
+  */
+  span<S> operator()(span<S> out, span<const S> a, span<const S> f) {
+    params(a, f);
+    return (*this)(out);
+  }
+
+  /** Oscillator bank, separate outputs \n
+      out: caller-provided output, holding a vector of vs
+      samples for each oscillator in turn \n
+      vs: vector size \n
+      returns out, trimmed to the oscillator outputs
+  */
+  span<S> partials(span<S> out, std::size_t vs) {
+    if (!nos)
+      return out.first(0);
+    rt_scope guard;
+    auto prof = this->profile();
+    std::size_t n = out.size() / nos < vs ? out.size() / nos : vs;
+    S *o = out.data();
+    for (std::size_t k = 0; k < nos; k++, o += n) {
+      double p = ph[k];
+      for (std::size_t i = 0; i < n; i++) {
+        p = p >= 1. ? p - 1. : p;
+        p = p < 0. ? p + 1. : p;
+        if constexpr (fsn != 0)
+          o[i] = (S)(p + fso);
+        else
+          o[i] = (S)(am[k] * FN(p, tab));
+        p = inc[k] + p;
+      }
+      if constexpr (fsn != 0) {
+        simd::sin2pi(o, o, n, fsq);
+        simd::mul(o, am[k], o, n);
+      }
+      ph[k] = p;
+    }
+    return out.first(n * nos);
+  }
+
+  /** Oscillator bank, summed output \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()() {
+    (*this)(this->sig_span(0));
+    return this->vector();
+  }
+
+  /** Oscillator bank, summed output \n
+      a: amplitudes \n
+      f: frequencies \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> a, span<const S> f) {
+    (*this)(this->sig_span(0), a, f);
+    return this->vector();
+  }
+
+  /** set the function table \n
+     t: function table
+ */
+  void table(const std::vector<S> *t) { tab = t; }
+
+  /** reset the oscillator bank \n
+      fs: sampling rate
+   */
+  void reset(S fs) {
+    ts = 1 / fs;
+    for (std::size_t k = 0; k < nos; k++)
+      inc[k] = fr[k] * ts;
+    std::fill(ph.begin(), ph.end(), 0.);
+  }
 };
 } // namespace Aurora
 
@@ -0,0 +1,261 @@
+// Oversample.h:
+// Oversampling wrapper
+// Cascaded polyphase halfband up/downsampling
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_OVERSAMPLE_
+#define _AURORA_OVERSAMPLE_
+
+#include "Resample.h"
+#include "SndBase.h"
+#include <cmath>
+
+namespace Aurora {
+
+/** Halfband class \n
+    2x polyphase halfband interpolator or decimator \n
+    S: sample type \n
+    a Kaiser-windowed halfband lowpass, whose coefficients are
+    zero at even offsets from the centre, so that only the odd
+    phase needs filtering: it is computed as a FIR over each
+    block, one vector multiply-add per tap.
+*/
+template <typename S = float> class Halfband {
+  aligned_vector<S> h;
+  aligned_vector<S> xb, eb, acc;
+  std::size_t m;
+  bool interp;
+
+public:
+  /** Constructor \n
+      mm: number of odd-phase taps on each side of the centre
+      (filter length 4 * mm - 1) \n
+      beta: Kaiser window parameter \n
+      up: interpolator (true) or decimator (false) \n
+      vsize: maximum number of low-rate samples per call
+  */
+  Halfband(std::size_t mm, double beta, bool up,
+           std::size_t vsize = def_vsize)
+      : h(2 * mm), xb(2 * mm - 1 + vsize), eb(mm - 1 + vsize),
+        acc(up ? vsize : 0), m(mm), interp(up) {
+    double sum = 0, wn = 1. / bessel_i0(beta);
+    for (std::size_t j = 0; j < 2 * m; j++) {
+      // odd offset k from the centre, k = 2m - 1 - 2j
+      double k = 2. * m - 1 - 2. * j, x = k / (2. * m);
+      double a = M_PI * k / 2;
+      h[j] = (S)(std::sin(a) / a * bessel_i0(beta * std::sqrt(1 - x * x)) * wn);
+      sum += h[j];
+    }
+    // DC gain of 1 for the decimator (odd phase sums to 1/2),
+    // 2 for the interpolator (odd phase sums to 1)
+    for (auto &c : h)
+      c *= (S)((interp ? 1. : 0.5) / sum);
+  }
+
+  /** Latency query \n
+      returns the delay in low-rate samples
+  */
+  std::size_t latency() const { return interp ? m : m - 1; }
+
+  /** Block size query \n
+      returns the maximum number of low-rate samples per call
+  */
+  std::size_t vsize() const { return xb.size() + 1 - 2 * m; }
+
+  /** Clear the filter state
+   */
+  void reset() {
+    std::fill(xb.begin(), xb.end(), 0);
+    std::fill(eb.begin(), eb.end(), 0);
+  }
+
+  /** Upsampling \n
+      in: low-rate input (up to vsize() samples) \n
+      out: high-rate output (2 * in.size() samples)
+  */
+  void up(span<const S> in, S *out) {
+    std::size_t n = in.size(), hl = 2 * m - 1;
+    S *x = xb.data(), *a = acc.data();
+    std::copy(in.begin(), in.end(), x + hl);
+    simd::mul(x, h[0], a, n);
+    for (std::size_t j = 1; j < 2 * m; j++)
+      simd::muladd(x + j, h[j], a, a, n);
+    for (std::size_t p = 0; p < n; p++) {
+      out[2 * p] = x[p + m - 1];
+      out[2 * p + 1] = a[p];
+    }
+    std::copy(x + n, x + n + hl, x);
+  }
+
+  /** Downsampling \n
+      in: high-rate input (up to 2 * vsize() samples, even) \n
+      out: low-rate output (in.size() / 2 samples)
+  */
+  void down(span<const S> in, S *out) {
+    std::size_t n = in.size() / 2, hl = 2 * m - 1, el = m - 1;
+    S *x = xb.data(), *e = eb.data();
+    for (std::size_t p = 0; p < n; p++) {
+      e[el + p] = in[2 * p];
+      x[hl + p] = in[2 * p + 1];
+    }
+    simd::mul(e, S(0.5), out, n);
+    for (std::size_t j = 0; j < 2 * m; j++)
+      simd::muladd(x + j, h[j], out, out, n);
+    std::copy(x + n, x + n + hl, x);
+    std::copy(e + n, e + n + el, e);
+  }
+};
+
+/** Oversample class \n
+    Oversampling wrapper for nonlinear processing \n
+    S: sample type \n
+    N: oversampling factor (2, 4, 8 or 16) \n
+    upsamples a signal through a cascade of 2x halfband stages,
+    runs a processing callable on it at N times the sampling
+    rate, and downsamples the result through the same cascade,
+    so that only a nonlinear section (e.g. Func saturation or a
+    TwoPole with drive) needs to run at the higher rate. Objects
+    in the callable should be set up for that rate (e.g. a
+    TwoPole constructed with N * fs). The first stage has a
+    47-tap filter, passing up to about 0.4 of the sampling rate
+    with about 75 dB rejection; later stages, at higher rates,
+    are shorter. The processing callable is f(out, in), taking
+    a high-rate output and input and returning the output span
+    (e.g. a lambda calling the span API of an object).
+*/
+template <typename S, std::size_t N> class Oversample : public SndBase<S> {
+  static_assert(N >= 2 && N <= 16 && !(N & (N - 1)),
+                "oversampling factor must be 2, 4, 8 or 16");
+  static constexpr std::size_t L = N < 4 ? 1 : (N < 8 ? 2 : (N < 16 ? 3 : 4));
+  std::vector<Halfband<S>> ups, downs;
+  aligned_vector<S> ba, bb;
+  std::size_t bs;
+
+  static std::size_t taps(std::size_t s) {
+    const std::size_t mm[] = {12, 4, 3, 2};
+    return mm[s];
+  }
+
+  span<S> upsample(span<const S> in) {
+    S *a = ba.data(), *b = bb.data();
+    std::size_t n = in.size();
+    ups[0].up(in, a);
+    for (std::size_t s = 1; s < L; s++) {
+      n *= 2;
+      ups[s].up(span<const S>(a, n), b);
+      std::swap(a, b);
+    }
+    return span<S>(a, 2 * n);
+  }
+
+  void downsample(span<const S> hi, S *out) {
+    S *a = hi.data() == ba.data() ? bb.data() : ba.data();
+    std::size_t n = hi.size();
+    for (std::size_t s = L - 1; s > 0; s--) {
+      downs[s].down(hi, a);
+      n /= 2;
+      hi = span<const S>(a, n);
+      a = a == ba.data() ? bb.data() : ba.data();
+    }
+    downs[0].down(hi, out);
+  }
+
+public:
+  /** Constructor \n
+      vsize: vector size (also the size of the blocks processed
+      at once, def_vsize if 0; longer inputs are processed in
+      blocks of this size)
+  */
+  Oversample(std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), ba(N * (vsize ? vsize : def_vsize)),
+        bb(N * (vsize ? vsize : def_vsize)), bs(vsize ? vsize : def_vsize) {
+    for (std::size_t s = 0; s < L; s++) {
+      ups.emplace_back(taps(s), 7., true, bs << s);
+      downs.emplace_back(taps(s), 7., false, bs << s);
+    }
+  }
+
+  /** Oversampling factor
+   */
+  static constexpr std::size_t factor() { return N; }
+
+  /** Latency query \n
+      returns the delay of the up/downsampling cascade, in
+      samples at the base rate
+  */
+  double latency() const {
+    double l = 0;
+    for (std::size_t s = 0; s < L; s++)
+      l += (double)(ups[s].latency() + downs[s].latency()) / (1 << s);
+    return l;
+  }
+
+  /** Clear the filter state
+   */
+  void reset() {
+    for (std::size_t s = 0; s < L; s++) {
+      ups[s].reset();
+      downs[s].reset();
+    }
+  }
+
+  /** Oversampled processing \n
+      out: caller-provided output \n
+      in: input \n
+      f: processing callable f(out, in), run at N times the rate \n
+      returns out, trimmed to the input size
+  */
+  template <typename F>
+  span<S> operator()(span<S> out, span<const S> in, F &&f) {
+    rt_scope guard;
+    auto prof = this->profile();
+    out = out.first(in.size());
+    for (std::size_t i = 0; i < out.size(); i += bs) {
+      std::size_t n = out.size() - i < bs ? out.size() - i : bs;
+      auto hi = upsample(span<const S>(in.data() + i, n));
+      S *o = hi.data() == ba.data() ? bb.data() : ba.data();
+      span<S> r = f(span<S>(o, hi.size()), span<const S>(hi));
+      if (r.data() != o)
+        std::copy(r.begin(), r.end(), o);
+      downsample(span<const S>(o, hi.size()), out.data() + i);
+    }
+    this->silent(false);
+    return out;
+  }
+
+  /** Oversampled processing \n
+      in: input \n
+      f: processing callable f(out, in), run at N times the rate
+  */
+  template <typename F>
+  const sig_vector<S> &operator()(span<const S> in, F &&f) {
+    (*this)(this->sig_span(in.size()), in, f);
+    return this->vector();
+  }
+};
+
+} // namespace Aurora
+#endif // _AURORA_OVERSAMPLE_
@@ -0,0 +1,377 @@
+// Profile.h
+// Processing call profiler
+// per-object and per-class timing statistics
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_PROFILE_
+#define _AURORA_PROFILE_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#ifdef AURORA_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#ifdef __GNUG__
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+#endif
+
+/* \file
+   Defining AURORA_PROFILE instruments the processing calls of
+   SndBase- and SpecBase-derived objects. Each call is timed, and
+   the statistics of each object (minimum, mean, 99th percentile and
+   maximum time per call) can be polled from any thread with
+   prof_report() or prof_print(), without locks. Objects are
+   registered when constructed and their statistics are kept (and
+   reported as no longer live) after they are destroyed. In other
+   builds, the instrumentation compiles to nothing and reports are
+   empty.
+*/
+namespace Aurora {
+
+/** Profiler time unit \n
+    returns "cycles" if the processor time stamp counter is used,
+    "ns" otherwise
+*/
+inline const char *prof_unit() {
+#if defined(AURORA_PROFILE) && (defined(__x86_64__) || defined(__i386__))
+  return "cycles";
+#elif defined(AURORA_PROFILE) && defined(__aarch64__)
+  return "ticks";
+#else
+  return "ns";
+#endif
+}
+
+/** Profiler statistics \n
+    times are given per processing call, in prof_unit() units
+*/
+struct prof_stats {
+  std::string name;       /**< class name */
+  const void *obj;        /**< object (nullptr in class totals) */
+  std::size_t objects;    /**< number of objects */
+  bool live;              /**< true if the object exists */
+  std::uint64_t calls;    /**< number of processing calls */
+  double min, mean, p99, max; /**< time per call */
+  double total;           /**< total time */
+  double load;            /**< share of the total time of all objects */
+};
+
+#ifdef AURORA_PROFILE
+/* \cond */
+inline std::uint64_t prof_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t t;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(t));
+  return t;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+/* log-linear histogram: values below 8 have a bucket each,
+   every octave above is split into 8 buckets */
+constexpr std::size_t prof_buckets = 304;
+
+inline std::size_t prof_bucket(std::uint64_t v) {
+  if (v < 8)
+    return v;
+  std::size_t e = 63 - __builtin_clzll(v);
+  if (e > 39)
+    return prof_buckets - 1;
+  return (e - 2) * 8 + ((v >> (e - 3)) & 7);
+}
+
+inline double prof_value(std::size_t b) {
+  if (b < 8)
+    return b;
+  std::size_t e = b / 8 + 2;
+  double w = (double)(1ull << (e - 3));
+  return (8 + b % 8) * w + w / 2;
+}
+
+/* per-object statistics, written by the processing thread
+   only (plain load and store), read by any thread */
+struct prof_record {
+  std::atomic<const std::type_info *> type;
+  std::atomic<const void *> obj;
+  std::atomic<std::uint64_t> n, sum, lo, hi;
+  std::atomic<std::uint32_t> hist[prof_buckets];
+  prof_record *next;
+
+  prof_record() : type(nullptr), obj(nullptr), n(0), sum(0), lo(0), hi(0),
+                  hist{}, next(nullptr) {}
+
+  void add(std::uint64_t t) {
+    constexpr auto rx = std::memory_order_relaxed;
+    std::uint64_t k = n.load(rx);
+    if (!k || t < lo.load(rx))
+      lo.store(t, rx);
+    if (t > hi.load(rx))
+      hi.store(t, rx);
+    sum.store(sum.load(rx) + t, rx);
+    auto &h = hist[prof_bucket(t)];
+    h.store(h.load(rx) + 1, rx);
+    n.store(k + 1, std::memory_order_release);
+  }
+
+  void clear() {
+    constexpr auto rx = std::memory_order_relaxed;
+    n.store(0, rx);
+    sum.store(0, rx);
+    lo.store(0, rx);
+    hi.store(0, rx);
+    for (auto &h : hist)
+      h.store(0, rx);
+  }
+};
+
+/* registry: an append-only list, so that it can be read
+   without locks while objects are created and destroyed */
+inline std::atomic<prof_record *> &prof_list() {
+  static std::atomic<prof_record *> head(nullptr);
+  return head;
+}
+
+inline std::string prof_name(const std::type_info *t) {
+  if (!t)
+    return "?";
+#ifdef __GNUG__
+  int st = 0;
+  char *s = abi::__cxa_demangle(t->name(), nullptr, nullptr, &st);
+  if (st == 0 && s) {
+    std::string r(s);
+    std::free(s);
+    return r;
+  }
+#endif
+  return t->name();
+}
+/* \endcond */
+
+/** prof_probe class \n
+    per-object profiling record, held by instrumented objects;
+    copies get a record of their own
+*/
+class prof_probe {
+  prof_record *rec;
+
+  static prof_record *make() {
+    auto *r = new prof_record;
+    auto &head = prof_list();
+    r->next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(r->next, r, std::memory_order_release,
+                                       std::memory_order_relaxed))
+      ;
+    return r;
+  }
+
+public:
+  prof_probe() : rec(make()) {}
+  prof_probe(const prof_probe &) : rec(make()) {}
+  prof_probe &operator=(const prof_probe &) { return *this; }
+  ~prof_probe() { rec->obj.store(nullptr, std::memory_order_relaxed); }
+
+  /** Record access
+   */
+  prof_record *record() const { return rec; }
+};
+
+/** prof_scope class \n
+    times a processing call, from construction to destruction
+*/
+class prof_scope {
+  prof_record *rec;
+  std::uint64_t t0;
+
+public:
+  /** Constructor \n
+      p: object probe \n
+      obj: object \n
+      t: object type
+  */
+  prof_scope(const prof_probe &p, const void *obj, const std::type_info &t)
+      : rec(p.record()) {
+    rec->type.store(&t, std::memory_order_relaxed);
+    rec->obj.store(obj, std::memory_order_relaxed);
+    t0 = prof_ticks();
+  }
+  ~prof_scope() { rec->add(prof_ticks() - t0); }
+  prof_scope(const prof_scope &) = delete;
+  prof_scope &operator=(const prof_scope &) = delete;
+};
+
+/* \cond */
+struct prof_acc {
+  std::uint64_t n = 0, sum = 0, lo = 0, hi = 0;
+  std::vector<std::uint64_t> hist = std::vector<std::uint64_t>(prof_buckets);
+
+  void add(const prof_record &r) {
+    constexpr auto rx = std::memory_order_relaxed;
+    std::uint64_t k = r.n.load(std::memory_order_acquire);
+    if (!k)
+      return;
+    std::uint64_t l = r.lo.load(rx), h = r.hi.load(rx);
+    lo = !n || l < lo ? l : lo;
+    hi = h > hi ? h : hi;
+    n += k;
+    sum += r.sum.load(rx);
+    for (std::size_t b = 0; b < prof_buckets; b++)
+      hist[b] += r.hist[b].load(rx);
+  }
+
+  void stats(prof_stats &s) const {
+    s.calls = n;
+    s.min = lo;
+    s.max = hi;
+    s.total = sum;
+    s.mean = n ? (double)sum / n : 0;
+    std::uint64_t c = 0, tot = 0;
+    for (auto h : hist)
+      tot += h;
+    s.p99 = 0;
+    for (std::size_t b = 0; b < prof_buckets; b++) {
+      c += hist[b];
+      if (tot && c * 100 >= tot * 99) {
+        s.p99 = std::min(std::max(prof_value(b), s.min), s.max);
+        break;
+      }
+    }
+  }
+};
+/* \endcond */
+#else
+/* \cond */
+class prof_probe {};
+/* \endcond */
+
+/** prof_scope class \n
+    times a processing call (no-op without AURORA_PROFILE)
+*/
+class prof_scope {
+public:
+  prof_scope() {}
+  ~prof_scope() {}
+};
+#endif
+
+/** Profiler report \n
+    classes: true for totals per class, false per object \n
+    returns the statistics of all objects (or classes) that have
+    processed audio, in decreasing order of total time \n
+    may be called from any thread; the statistics are read as
+    they are being updated, so that a report may be slightly out
+    of step with the processing thread
+*/
+inline std::vector<prof_stats> prof_report(bool classes = false) {
+  std::vector<prof_stats> res;
+#ifdef AURORA_PROFILE
+  std::vector<std::string> names;
+  std::vector<prof_acc> acc;
+  double all = 0;
+  for (auto *r = prof_list().load(std::memory_order_acquire); r; r = r->next) {
+    if (!r->n.load(std::memory_order_acquire))
+      continue;
+    std::string name = prof_name(r->type.load(std::memory_order_relaxed));
+    const void *obj = r->obj.load(std::memory_order_relaxed);
+    std::size_t k = res.size();
+    if (classes)
+      k = std::find(names.begin(), names.end(), name) - names.begin();
+    if (k == res.size()) {
+      res.push_back({name, classes ? nullptr : obj, 0, false, 0, 0, 0, 0, 0,
+                     0, 0});
+      names.push_back(name);
+      acc.emplace_back();
+    }
+    res[k].objects++;
+    res[k].live = res[k].live || obj != nullptr;
+    acc[k].add(*r);
+  }
+  for (std::size_t k = 0; k < res.size(); k++) {
+    acc[k].stats(res[k]);
+    all += res[k].total;
+  }
+  for (auto &s : res)
+    s.load = all > 0 ? s.total / all : 0;
+  std::sort(res.begin(), res.end(),
+            [](const prof_stats &a, const prof_stats &b) {
+              return a.total > b.total;
+            });
+#else
+  (void)classes;
+#endif
+  return res;
+}
+
+/** Profiler report printout \n
+    os: output stream \n
+    classes: true for totals per class, false per object
+*/
+inline void prof_print(std::ostream &os, bool classes = true) {
+  os << (classes ? "class" : "object")
+     << "\tcalls\tmin\tmean\tp99\tmax\tload (%)"
+     << " [" << prof_unit() << "/call]" << std::endl;
+  for (auto &s : prof_report(classes)) {
+    os << s.name;
+    if (classes)
+      os << " (" << s.objects << ")";
+    else if (!s.live)
+      os << " (destroyed)";
+    else
+      os << " @" << s.obj;
+    os << "\t" << s.calls << "\t" << s.min << "\t" << s.mean << "\t" << s.p99
+       << "\t" << s.max << "\t" << 100 * s.load << std::endl;
+  }
+}
+
+/** Profiler reset \n
+    clears the statistics of all objects; meant to be called
+    while objects are not processing, as updates made at the same
+    time may be lost or partly kept
+*/
+inline void prof_reset() {
+#ifdef AURORA_PROFILE
+  for (auto *r = prof_list().load(std::memory_order_acquire); r; r = r->next)
+    r->clear();
+#endif
+}
+
+} // namespace Aurora
+
+#endif // _AURORA_PROFILE_
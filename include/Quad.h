@@ -57,11 +57,11 @@ namespace Aurora {
       S: sample type
   */
   template <typename S = float> class Quad : public SndBase<S> {
-    using SndBase<S>::get_sig;
     double d1[6], d2[6];
     double c1[6], c2[6];
-    std::vector<S> im;
+    sig_vector<S> im;
     S ts;
+    Tail<S> tl;
 
     std::complex<S> filter(S s, double *cr, double *ci, double *dr, double *di) {
       S w;
@@ -92,28 +92,64 @@ namespace Aurora {
 						       };
 
 
-    const std::vector<S> &operator()(const std::vector<S> &in) {
-      std::size_t n = 0;
+    /** Quadrature filter \n
+	re: caller-provided real output \n
+	im: caller-provided imaginary output \n
+	in: input \n
+	returns re, trimmed to the shortest size
+    */
+    span<S> operator()(span<S> re, span<S> im, span<const S> in) {
+      rt_scope guard;
+      auto prof = this->profile();
       std::complex<S> cs;
-      auto &re = get_sig();
-      this->vsize(in.size());
-      im.resize(in.size());
-      for(auto &s : in) {
-	cs = filter(s,c1,c2,d1,d2);
+      re = re.first(in.size() < im.size() ? in.size() : im.size());
+      im = im.first(re.size());
+      if(tl.skip(in.first(re.size()))) {
+	std::fill(im.begin(), im.end(), 0);
+	return this->mute(re);
+      }
+      this->silent(false);
+      for(std::size_t n = 0; n < re.size(); n++) {
+	cs = filter(in[n],c1,c2,d1,d2);
 	re[n] = cs.real();
-	im[n++] = cs.imag();
-      }	
+	im[n] = cs.imag();
+      }
+      if(tl.on() && tl.quiet(d1, 6) && tl.quiet(d2, 6) &&
+	 tl.quiet(re) && tl.quiet(im)) {
+	std::fill(d1, d1 + 6, 0);
+	std::fill(d2, d2 + 6, 0);
+	tl.idle(true);
+      }
       return re;
     }
 
-    const std::vector<S> &real() const {
-      return get_sig();
+    const sig_vector<S> &operator()(span<const S> in) {
+      rt_resize(im, in.size());
+      (*this)(this->sig_span(in.size()), span<S>(im), in);
+      return this->vector();
     }
 
-    const std::vector<S> &imag() const {
+    const sig_vector<S> &real() const {
+      return this->vector();
+    }
+
+    const sig_vector<S> &imag() const {
       return im;
     }
     
+    /** Tail detection \n
+	th: silence threshold (< 0 turns detection off) \n
+	when the allpass states and outputs decay to within the
+	threshold, the filter goes idle and skips processing until
+	non-silent input arrives
+    */
+    void tail(S th) { tl.threshold(th); }
+
+    /** Idle state query \n
+	returns true if the filter is idle
+    */
+    bool idle() const { return tl.idle(); }
+
     void reset(S fs) {
       ts = 1/fs;
       S a;
@@ -0,0 +1,323 @@
+// Resample.h:
+// Sample-rate conversion
+// Polyphase windowed-sinc resampler
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_RESAMPLE_
+#define _AURORA_RESAMPLE_
+
+#include "SndBase.h"
+#include <cmath>
+
+namespace Aurora {
+
+/** Resampler quality presets \n
+    RS_FAST: 20 taps, passband to 80% of Nyquist, about 55 dB
+    stopband rejection \n
+    RS_MEDIUM: 38 taps, 85% of Nyquist, about 80 dB \n
+    RS_BEST: 72 taps, 90% of Nyquist, about 100 dB \n
+    (taps at ratios of 1 or more; downsampling widens the kernel
+    by the inverse of the lowest ratio)
+*/
+enum rs_quality : int32_t { RS_FAST = 0, RS_MEDIUM, RS_BEST };
+
+/* \cond */
+struct rs_preset {
+  std::size_t zc;     // zero crossings on each side
+  std::size_t phases; // kernel phases
+  double beta;        // Kaiser window parameter
+  double roll;        // cutoff, relative to the lower Nyquist frequency
+};
+
+inline rs_preset rs_settings(rs_quality q) {
+  const rs_preset p[] = {
+      {8, 64, 5., .8}, {16, 256, 7.9, .85}, {32, 512, 10., .9}};
+  return p[q < RS_FAST ? RS_FAST : (q > RS_BEST ? RS_BEST : q)];
+}
+
+/* modified Bessel function of the first kind, order 0 */
+inline double bessel_i0(double x) {
+  double s = 1, t = 1;
+  for (int k = 1; k < 50 && t > 1e-12 * s; k++) {
+    t *= (x / (2 * k)) * (x / (2 * k));
+    s += t;
+  }
+  return s;
+}
+/* \endcond */
+
+/** Resample class \n
+    Polyphase sample-rate converter \n
+    S: sample type \n
+    converts a stream by an arbitrary ratio (output rate / input
+    rate), which can be varied on every call. Each output sample
+    is a windowed-sinc interpolation of the input, using the two
+    nearest of a table of kernel phases, with the kernel products
+    computed by the vector kernels (simd::dot). Output sample n
+    lines up with input time n / ratio, but is only produced once
+    latency() input samples past that time have been received.
+*/
+template <typename S = float> class Resample : public SndBase<S> {
+  aligned_vector<S> kern;
+  aligned_vector<S> buf;
+  std::size_t taps, phs;
+  double pos, rt, rmin;
+
+  static std::size_t halflen(const rs_preset &p, double r) {
+    return (std::size_t)std::ceil(p.zc / (p.roll * (r < 1 ? r : 1)));
+  }
+
+  /* builds the kernel table, reallocating only if it grows
+     (never if AURORA_RT_SAFE is defined) */
+  bool kernel(rs_quality q, double r) {
+    rs_preset p = rs_settings(q);
+    double fc = p.roll * (r < 1 ? r : 1);
+    std::size_t half = halflen(p, r), n = (p.phases + 1) * 2 * half;
+    if (rt_resize(kern, n) < n)
+      return false;
+    taps = 2 * half;
+    phs = p.phases;
+    double wn = 1. / bessel_i0(p.beta);
+    for (std::size_t k = 0; k <= phs; k++) {
+      for (std::size_t j = 0; j < taps; j++) {
+        double u = (double)k / phs + half - 1. - j;
+        double x = u / half, w = 0;
+        if (x * x < 1)
+          w = bessel_i0(p.beta * std::sqrt(1 - x * x)) * wn;
+        double a = M_PI * fc * u;
+        kern[k * taps + j] = (S)(fc * w * (u == 0 ? 1 : std::sin(a) / a));
+      }
+    }
+    return true;
+  }
+
+  S interp(const S *x, double frac) const {
+    double ph = frac * phs;
+    std::size_t k = (std::size_t)ph;
+    S f = (S)(ph - k);
+    const S *c = kern.data() + k * taps;
+    S a = simd::dot(x, c, taps);
+    if (f == 0)
+      return a;
+    return a + f * (simd::dot(x, c + taps, taps) - a);
+  }
+
+  std::size_t insize(std::size_t vsize) const {
+    return taps + (std::size_t)std::ceil(vsize / rmin) + 2;
+  }
+
+public:
+  /** Constructor \n
+      r: conversion ratio (output rate / input rate) \n
+      q: quality preset (RS_FAST, RS_MEDIUM, RS_BEST) \n
+      rlo: lowest ratio used (for variable-ratio conversion;
+      0 for r), setting the kernel cutoff against aliasing \n
+      vsize: output vector size
+  */
+  Resample(double r, rs_quality q = RS_MEDIUM, double rlo = 0,
+           std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), pos(0), rt(r), rmin(rlo > 0 ? rlo : r) {
+    rs_preset p = rs_settings(q);
+    kern.resize((p.phases + 1) * 2 * halflen(p, rmin));
+    kernel(q, rmin);
+    buf.reserve(insize(vsize));
+    reset();
+  };
+
+  /** Reset the conversion \n
+      clears the input history, so that the next output sample
+      lines up with the next input sample
+  */
+  void reset() {
+    rt_resize(buf, taps / 2 - 1);
+    std::fill(buf.begin(), buf.end(), 0);
+    pos = buf.size();
+  }
+
+  /** Reset the converter \n
+      r: conversion ratio \n
+      q: quality preset \n
+      rlo: lowest ratio used (0 for r) \n
+      if AURORA_RT_SAFE is defined, settings needing a larger
+      kernel table are refused, reusing memory
+  */
+  void reset(double r, rs_quality q = RS_MEDIUM, double rlo = 0) {
+    if (kernel(q, rlo > 0 ? rlo : r)) {
+      rt = r;
+      rmin = rlo > 0 ? rlo : r;
+      reset();
+    }
+  }
+
+  /** Ratio query \n
+      returns the ratio of the last conversion
+  */
+  double ratio() const { return rt; }
+
+  /** Latency query \n
+      returns the number of input samples needed past the
+      time of an output sample before it is produced
+  */
+  std::size_t latency() const { return taps / 2; }
+
+  /** Kernel size query \n
+      returns the number of taps of the interpolation kernel
+  */
+  std::size_t size() const { return taps; }
+
+  /** Preallocate vector memory \n
+      size: output vector size to reserve in memory \n
+      also reserves the input history for blocks producing
+      this many samples at the lowest ratio. If AURORA_RT_SAFE
+      is defined, it sets the maximum vector size.
+  */
+  void prealloc(std::size_t size) {
+    SndBase<S>::prealloc(size);
+    buf.reserve(insize(size));
+  }
+
+  /** Convert \n
+      out: caller-provided output \n
+      in: input \n
+      r: conversion ratio (output rate / input rate) \n
+      returns out, trimmed to the number of samples produced \n
+      out needs to hold in.size() * r + 1 samples for a whole
+      input block to be converted; any input not converted is
+      held for the next call. If AURORA_RT_SAFE is defined, input
+      beyond the reserved history is dropped.
+  */
+  span<S> operator()(span<S> out, span<const S> in, double r) {
+    rt_scope guard;
+    auto prof = this->profile();
+    std::size_t len = buf.size(), half = taps / 2, i = 0;
+    if (r > 0)
+      rt = r;
+    std::size_t m = rt_resize(buf, len + in.size()) - len;
+    std::copy(in.begin(), in.begin() + m, buf.begin() + len);
+    len += m;
+    double step = 1. / rt;
+    const S *x = buf.data();
+    for (std::size_t k = (std::size_t)pos; i < out.size() && k + half < len;
+         k = (std::size_t)pos) {
+      out[i++] = interp(x + k + 1 - half, pos - k);
+      pos += step;
+    }
+    std::size_t d = (std::size_t)pos + 1 - half;
+    if (d > len)
+      d = len;
+    std::copy(buf.begin() + d, buf.end(), buf.begin());
+    buf.resize(len - d);
+    pos -= d;
+    this->silent(false);
+    return out.first(i);
+  }
+
+  /** Convert \n
+      out: caller-provided output \n
+      in: input \n
+      returns out, trimmed to the number of samples produced
+  */
+  span<S> operator()(span<S> out, span<const S> in) {
+    return (*this)(out, in, rt);
+  }
+
+  /** Convert \n
+      in: input \n
+      r: conversion ratio (output rate / input rate) \n
+      returns the output vector, sized to the number of
+      samples produced
+  */
+  const sig_vector<S> &operator()(span<const S> in, double r) {
+    if (r > 0)
+      rt = r;
+    std::size_t n = (std::size_t)std::ceil((buf.size() + in.size()) * rt) + 1;
+    auto out = (*this)(this->sig_span(n), in, rt);
+    this->vsize(out.size());
+    return this->vector();
+  }
+
+  /** Convert \n
+      in: input \n
+      returns the output vector, sized to the number of
+      samples produced
+  */
+  const sig_vector<S> &operator()(span<const S> in) {
+    return (*this)(in, rt);
+  }
+
+  /** Offline conversion \n
+      src: source signal \n
+      wrap: true if src is one period of a periodic signal \n
+      returns src converted at the current ratio, with
+      src.size() * ratio() samples (rounded). Periodic signals,
+      such as wavetables, are converted across the wraparound,
+      so that a table can be resized to any length; others are
+      taken as silent outside src. The conversion state is not
+      used. This allocates memory and is not meant for the
+      processing path.
+  */
+  std::vector<S> convert(span<const S> src, bool wrap = false) const {
+    std::size_t n = src.size(), half = taps / 2;
+    std::vector<S> out((std::size_t)std::round(n * rt));
+    if (!n || out.empty())
+      return out;
+    std::vector<S> x(n + taps + 1, 0);
+    for (std::size_t j = 0; j < x.size(); j++) {
+      // x[j] holds src[j - half + 1]
+      long k = (long)j - (long)half + 1;
+      if (wrap)
+        x[j] = src[((k % (long)n) + n) % n];
+      else if (k >= 0 && k < (long)n)
+        x[j] = src[k];
+    }
+    double step = wrap ? (double)n / out.size() : 1. / rt;
+    for (std::size_t i = 0; i < out.size(); i++) {
+      double t = i * step;
+      std::size_t k = (std::size_t)t;
+      out[i] = interp(x.data() + k, t - k);
+    }
+    return out;
+  }
+};
+
+/** Sample-rate conversion of a signal \n
+    src: source signal \n
+    r: conversion ratio (output rate / input rate) \n
+    wrap: true if src is one period of a periodic signal \n
+    q: quality preset \n
+    returns the converted signal (see Resample::convert()),
+    e.g. an impulse response recorded at another rate, before
+    it is given to IR or Conv, or a table resized to len samples
+    with r = len / src.size() and wrap = true
+*/
+template <typename S>
+std::vector<S> resample(span<const S> src, double r, bool wrap = false,
+                        rs_quality q = RS_MEDIUM) {
+  return Resample<S>(r, q, 0, 0).convert(src, wrap);
+}
+
+} // namespace Aurora
+#endif // _AURORA_RESAMPLE_
@@ -0,0 +1,84 @@
+// RtGuard.h
+// Allocation guard for real-time processing
+// replacement global allocation functions
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_RTGUARD_
+#define _AURORA_RTGUARD_
+
+#include "SndBase.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/* \file
+   In AURORA_RT_GUARD builds (AURORA_RT_SAFE without NDEBUG),
+   including this header in one (and only one) translation unit
+   of a program replaces the global allocation functions, so that
+   any memory allocated inside a processing call (see rt_scope)
+   is reported to Aurora::rt_alloc_hook. In other builds it has
+   no effect.
+*/
+#ifdef AURORA_RT_GUARD
+namespace Aurora {
+/* \cond */
+inline void *rt_alloc(std::size_t n, std::size_t align) {
+  if (rt_depth())
+    rt_alloc_hook(n);
+  n = n ? n : 1;
+  void *p = align > alignof(std::max_align_t)
+                ? std::aligned_alloc(align, (n + align - 1) / align * align)
+                : std::malloc(n);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+/* \endcond */
+} // namespace Aurora
+
+void *operator new(std::size_t n) { return Aurora::rt_alloc(n, 0); }
+void *operator new[](std::size_t n) { return Aurora::rt_alloc(n, 0); }
+void *operator new(std::size_t n, std::align_val_t a) {
+  return Aurora::rt_alloc(n, static_cast<std::size_t>(a));
+}
+void *operator new[](std::size_t n, std::align_val_t a) {
+  return Aurora::rt_alloc(n, static_cast<std::size_t>(a));
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept {
+  std::free(p);
+}
+#endif
+
+#endif // _AURORA_RTGUARD_
@@ -0,0 +1,875 @@
+// Simd.h
+// Vector kernels for elementwise operations
+// with runtime instruction set dispatch
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_SIMD_
+#define _AURORA_SIMD_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(AURORA_NO_SIMD) && defined(__x86_64__) &&                        \
+    (defined(__GNUC__) || defined(__clang__))
+#define AURORA_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace Aurora {
+
+/** instruction set selectors for the vector kernels
+ */
+enum simd_isa : int32_t { SIMD_SCALAR = 0, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 };
+
+/** Addition function for BinOp \n
+    (vectorised)
+*/
+template <typename S> inline S plus(S a, S b) { return a + b; }
+
+/** Subtraction function for BinOp
+ */
+template <typename S> inline S minus(S a, S b) { return a - b; }
+
+/** Multiplication function for BinOp \n
+    (vectorised)
+*/
+template <typename S> inline S times(S a, S b) { return a * b; }
+
+/** Absolute value (full-wave rectifier) function for Func \n
+    (vectorised)
+*/
+template <typename S> inline S rect(S a) { return a < 0 ? -a : a; }
+
+/** Hard clipping (-1 to 1) function for Func \n
+    (vectorised)
+*/
+template <typename S> inline S clip(S a) {
+  return a < -1 ? (S)-1 : (a > 1 ? (S)1 : a);
+}
+
+/** Fast tanh approximation for Func \n
+    (vectorised) \n
+    Lambert [7/6] continued fraction, input limited to +/-5
+    and output to +/-1. Max abs error is 1e-4 (near +/-5),
+    under 1e-6 for |x| < 3.
+*/
+template <typename S> inline S tanha(S x) {
+  x = x < -5 ? (S)-5 : (x > 5 ? (S)5 : x);
+  S x2 = x * x;
+  S num = x * ((S)135135 + x2 * ((S)17325 + x2 * ((S)378 + x2)));
+  S den = (S)135135 + x2 * ((S)62370 + x2 * ((S)3150 + (S)28 * x2));
+  S y = num / den;
+  return y < -1 ? (S)-1 : (y > 1 ? (S)1 : y);
+}
+
+/** sinusoid polynomial accuracy (see sinpoly) */
+enum sin_quality : int32_t { SIN_FAST = 0, SIN_MEDIUM, SIN_BEST };
+
+/* minimax coefficients of sin(2 pi t) for t in [-1/4, 1/4], in odd
+   powers of t (degrees 5, 7 and 11) */
+constexpr int sin_terms[3] = {3, 4, 6};
+constexpr double sin_coefs[3][6] = {
+    {6.2812800766394998, -41.095242688673395, 73.585514753586665},
+    {6.283164044302505, -41.337142371122624, 81.340768888699372,
+     -70.993433282779748},
+    {6.2831853064875069, -41.341701929773237, 81.605209431132678,
+     -76.703667829715414, 41.99998986155547, -14.337024894362838}};
+
+/* round to nearest integer (|x| < 2^31), through an integer
+   conversion, as the vector kernels do, so that it is not
+   optimised away under -ffast-math
+*/
+template <typename S> inline S nearest(S x) {
+#ifdef AURORA_SIMD_X86
+  if constexpr (sizeof(S) < 8)
+    return (S)_mm_cvtss_si32(_mm_set_ss(x));
+  else
+    return (S)_mm_cvtsd_si32(_mm_set_sd(x));
+#else
+  return std::nearbyint(x);
+#endif
+}
+
+/** Fast sine of a normalised phase for Osc and Func \n
+    (vectorised) \n
+    x: phase in cycles (|x| < 2^31) \n
+    q: accuracy, max abs error (double): SIN_FAST 6.8e-5,
+    SIN_MEDIUM 5.9e-7, SIN_BEST 1.3e-11 (float rounding raises the
+    last two to 7.4e-7 and 2e-7) \n
+    returns sin(2 pi x). The phase is reduced to [-1/2, 1/2] by
+    rounding, then folded to [-1/4, 1/4], with no branches.
+*/
+template <typename S> inline S sinpoly(S x, int q = SIN_MEDIUM) {
+  S r = x - nearest(x);
+  S u = (S).5 - r, v = (S)-.5 - r;
+  S t = r < u ? r : u;
+  t = t > v ? t : v;
+  S t2 = t * t;
+  int k = sin_terms[q] - 1;
+  S p = (S)sin_coefs[q][k];
+  while (k--)
+    p = p * t2 + (S)sin_coefs[q][k];
+  return p * t;
+}
+
+namespace simd {
+
+/* \cond */
+template <typename S>
+constexpr bool is_vec =
+    std::is_same<S, float>::value || std::is_same<S, double>::value;
+
+inline simd_isa detect() {
+#ifdef AURORA_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+    return SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return SIMD_AVX2;
+  return SIMD_SSE2;
+#else
+  return SIMD_SCALAR;
+#endif
+}
+
+inline simd_isa &selected() {
+  static simd_isa sel = detect();
+  return sel;
+}
+
+/* scalar kernels, also used for the vector loop remainders */
+#define AURORA_SIMD_SCALAR_KERNELS                                           \
+  template <typename S>                                                      \
+  void add(const S *a, const S *b, S *o, std::size_t n, std::size_t i = 0) { \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] + b[i];                                                    \
+  }                                                                          \
+  template <typename S>                                                      \
+  void add(const S *a, S b, S *o, std::size_t n, std::size_t i = 0) {        \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] + b;                                                       \
+  }                                                                          \
+  template <typename S>                                                      \
+  void mul(const S *a, const S *b, S *o, std::size_t n, std::size_t i = 0) { \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] * b[i];                                                    \
+  }                                                                          \
+  template <typename S>                                                      \
+  void mul(const S *a, S b, S *o, std::size_t n, std::size_t i = 0) {        \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] * b;                                                       \
+  }                                                                          \
+  template <typename S>                                                      \
+  void muladd(const S *a, const S *b, const S *c, S *o, std::size_t n,       \
+              std::size_t i = 0) {                                           \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] * b[i] + c[i];                                             \
+  }                                                                          \
+  template <typename S>                                                      \
+  void muladd(const S *a, S b, const S *c, S *o, std::size_t n,              \
+              std::size_t i = 0) {                                           \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] * b + c[i];                                                \
+  }                                                                          \
+  template <typename S>                                                      \
+  void scaloffs(const S *a, S scal, S offs, S *o, std::size_t n,             \
+                std::size_t i = 0) {                                         \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] * scal + offs;                                             \
+  }                                                                          \
+  template <typename S>                                                      \
+  void abs(const S *a, S *o, std::size_t n, std::size_t i = 0) {             \
+    for (; i < n; i++)                                                       \
+      o[i] = rect(a[i]);                                                     \
+  }                                                                          \
+  template <typename S>                                                      \
+  void clip(const S *a, S lo, S hi, S *o, std::size_t n,                     \
+            std::size_t i = 0) {                                             \
+    for (; i < n; i++)                                                       \
+      o[i] = a[i] < lo ? lo : (a[i] > hi ? hi : a[i]);                       \
+  }                                                                          \
+  template <typename S>                                                      \
+  void tanh(const S *a, S *o, std::size_t n, std::size_t i = 0) {            \
+    for (; i < n; i++)                                                       \
+      o[i] = tanha(a[i]);                                                    \
+  }                                                                          \
+  template <typename S>                                                      \
+  S peak(const S *a, std::size_t n, std::size_t i = 0, S m = 0) {            \
+    for (; i < n; i++)                                                       \
+      m = rect(a[i]) > m || a[i] != a[i] ? rect(a[i]) : m;                   \
+    return m;                                                                \
+  }                                                                          \
+  template <typename S>                                                      \
+  S dot(const S *a, const S *b, std::size_t n, std::size_t i = 0, S s = 0) { \
+    for (; i < n; i++)                                                       \
+      s += a[i] * b[i];                                                      \
+    return s;                                                                \
+  }                                                                          \
+  template <typename S>                                                      \
+  void lerp(const S *t, const S *p, S *o, std::size_t n, std::size_t i = 0) {\
+    for (; i < n; i++) {                                                     \
+      int32_t k = (int32_t)p[i];                                             \
+      S f = p[i] - (S)k;                                                     \
+      o[i] = t[k] + f * (t[k + 1] - t[k]);                                   \
+    }                                                                        \
+  }                                                                          \
+  template <typename S>                                                      \
+  void cubic(const S *t, const S *p, S *o, std::size_t n,                    \
+             std::size_t i = 0) {                                            \
+    for (; i < n; i++) {                                                     \
+      int32_t k = (int32_t)p[i];                                             \
+      S f = p[i] - (S)k, a = t[k - 1], b = t[k], c = t[k + 1], d = t[k + 2]; \
+      S e = d + (S)3 * b;                                                    \
+      S c3 = ((e - a) - (S)3 * c) / (S)6;                                    \
+      S c2 = (a + c) * (S).5 - b;                                            \
+      S c1 = c - (a + a + e) / (S)6;                                         \
+      o[i] = ((c3 * f + c2) * f + c1) * f + b;                               \
+    }                                                                        \
+  }                                                                          \
+  template <typename S>                                                      \
+  void hermite(const S *t, const S *p, S *o, std::size_t n,                  \
+               std::size_t i = 0) {                                          \
+    for (; i < n; i++) {                                                     \
+      int32_t k = (int32_t)p[i];                                             \
+      S f = p[i] - (S)k, a = t[k - 1], b = t[k], c = t[k + 1], d = t[k + 2]; \
+      S c1 = (c - a) * (S).5;                                                \
+      S c2 = ((a - (S)2.5 * b) + (c + c)) - (S).5 * d;                       \
+      S c3 = (d - a) * (S).5 + (b - c) * (S)1.5;                             \
+      o[i] = ((c3 * f + c2) * f + c1) * f + b;                               \
+    }                                                                        \
+  }                                                                          \
+  template <typename S>                                                      \
+  void sin2pi(const S *a, S *o, std::size_t n, int q, std::size_t i = 0) {   \
+    for (; i < n; i++)                                                       \
+      o[i] = sinpoly(a[i], q);                                               \
+  }
+
+namespace scalar {
+AURORA_SIMD_SCALAR_KERNELS
+}
+
+#ifdef AURORA_SIMD_X86
+
+/* vector kernels, stamped out for each instruction set: V is the
+   register traits type, ATTR the function target attribute.
+   Operation order matches the scalar kernels, so results are
+   bit-exact (no FMA contraction is used), except for dot(), which
+   sums in lanes. min(a, b) and max(a, b) return b when a and b
+   compare equal or either is a NaN, so operands are ordered as
+   the scalar comparisons are: abs() is max(0 - x, x), keeping -0
+   and NaN as rect() does, and clip() is min(hi, max(lo, x)),
+   passing NaN through.
+*/
+#define AURORA_SIMD_KERNELS(ATTR)                                            \
+  template <typename S> ATTR void add(const S *a, const S *b, S *o,          \
+                                      std::size_t n) {                       \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::add(V::ld(a + i), V::ld(b + i)));                      \
+    scalar::add(a, b, o, n, i);                                              \
+  }                                                                          \
+  template <typename S> ATTR void add(const S *a, S b, S *o, std::size_t n) {\
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto vb = V::set(b);                                                     \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::add(V::ld(a + i), vb));                                \
+    scalar::add(a, b, o, n, i);                                              \
+  }                                                                          \
+  template <typename S> ATTR void mul(const S *a, const S *b, S *o,          \
+                                      std::size_t n) {                       \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::mul(V::ld(a + i), V::ld(b + i)));                      \
+    scalar::mul(a, b, o, n, i);                                              \
+  }                                                                          \
+  template <typename S> ATTR void mul(const S *a, S b, S *o, std::size_t n) {\
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto vb = V::set(b);                                                     \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::mul(V::ld(a + i), vb));                                \
+    scalar::mul(a, b, o, n, i);                                              \
+  }                                                                          \
+  template <typename S> ATTR void muladd(const S *a, const S *b,             \
+                                         const S *c, S *o, std::size_t n) {  \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i,                                                           \
+            V::add(V::mul(V::ld(a + i), V::ld(b + i)), V::ld(c + i)));       \
+    scalar::muladd(a, b, c, o, n, i);                                        \
+  }                                                                          \
+  template <typename S> ATTR void muladd(const S *a, S b, const S *c, S *o,  \
+                                         std::size_t n) {                    \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto vb = V::set(b);                                                     \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::add(V::mul(V::ld(a + i), vb), V::ld(c + i)));          \
+    scalar::muladd(a, b, c, o, n, i);                                        \
+  }                                                                          \
+  template <typename S> ATTR void scaloffs(const S *a, S scal, S offs, S *o, \
+                                           std::size_t n) {                  \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto vs = V::set(scal), vo = V::set(offs);                               \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::add(V::mul(V::ld(a + i), vs), vo));                    \
+    scalar::scaloffs(a, scal, offs, o, n, i);                                \
+  }                                                                          \
+  template <typename S> ATTR void abs(const S *a, S *o, std::size_t n) {     \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto z = V::set(0);                                                      \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(a + i);                                                 \
+      V::st(o + i, V::max(V::sub(z, x), x));                                 \
+    }                                                                        \
+    scalar::abs(a, o, n, i);                                                 \
+  }                                                                          \
+  template <typename S> ATTR void clip(const S *a, S lo, S hi, S *o,         \
+                                       std::size_t n) {                      \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto vl = V::set(lo), vh = V::set(hi);                                   \
+    for (; i + V::N <= n; i += V::N)                                         \
+      V::st(o + i, V::min(vh, V::max(vl, V::ld(a + i))));                    \
+    scalar::clip(a, lo, hi, o, n, i);                                        \
+  }                                                                          \
+  template <typename S> ATTR void tanh(const S *a, S *o, std::size_t n) {    \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto lim = V::set(5), one = V::set(1), c0 = V::set(135135),              \
+         c1 = V::set(17325), c2 = V::set(378), c3 = V::set(62370),           \
+         c4 = V::set(3150), c5 = V::set(28);                                 \
+    auto nlim = V::set(-5), none = V::set(-1);                               \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::min(lim, V::max(nlim, V::ld(a + i)));                      \
+      auto x2 = V::mul(x, x);                                                \
+      auto num = V::mul(                                                     \
+          x, V::add(c0, V::mul(x2, V::add(c1, V::mul(x2, V::add(c2, x2)))))); \
+      auto den = V::add(                                                     \
+          c0, V::mul(x2, V::add(c3, V::mul(x2, V::add(c4, V::mul(c5, x2)))))); \
+      V::st(o + i, V::min(one, V::max(none, V::div(num, den))));             \
+    }                                                                        \
+    scalar::tanh(a, o, n, i);                                                \
+  }                                                                          \
+  template <typename S> ATTR S peak(const S *a, std::size_t n) {             \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    S l[V::N], m = 0;                                                        \
+    auto vm = V::set(0), vz = vm;                                            \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(a + i);                                                 \
+      vm = V::max(V::abs(x), vm);                                            \
+      vz = V::add(vz, V::sub(x, x));                                         \
+    }                                                                        \
+    S z = V::sum(vz);                                                        \
+    if (z != z)                                                              \
+      return scalar::peak(a, n);                                             \
+    V::st(l, vm);                                                            \
+    for (std::size_t j = 0; j < V::N; j++)                                   \
+      m = l[j] > m ? l[j] : m;                                               \
+    return scalar::peak(a, n, i, m);                                         \
+  }                                                                          \
+  template <typename S> ATTR S dot(const S *a, const S *b, std::size_t n) {  \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto v0 = V::set(0), v1 = V::set(0);                                     \
+    for (; i + 2 * V::N <= n; i += 2 * V::N) {                               \
+      v0 = V::add(v0, V::mul(V::ld(a + i), V::ld(b + i)));                   \
+      v1 = V::add(v1, V::mul(V::ld(a + i + V::N), V::ld(b + i + V::N)));     \
+    }                                                                        \
+    if (i + V::N <= n) {                                                     \
+      v0 = V::add(v0, V::mul(V::ld(a + i), V::ld(b + i)));                   \
+      i += V::N;                                                             \
+    }                                                                        \
+    return scalar::dot(a, b, n, i, V::sum(V::add(v0, v1)));                  \
+  }                                                                          \
+  template <typename S> ATTR void lerp(const S *t, const S *p, S *o,         \
+                                       std::size_t n) {                      \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(p + i);                                                 \
+      auto k = V::idx(x);                                                    \
+      auto f = V::sub(x, V::flt(k));                                         \
+      auto a = V::gat(t, k), b = V::gat(t + 1, k);                           \
+      V::st(o + i, V::add(a, V::mul(f, V::sub(b, a))));                      \
+    }                                                                        \
+    scalar::lerp(t, p, o, n, i);                                             \
+  }                                                                          \
+  template <typename S> ATTR void cubic(const S *t, const S *p, S *o,        \
+                                        std::size_t n) {                     \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto three = V::set(3), six = V::set(6), half = V::set(.5);              \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(p + i);                                                 \
+      auto k = V::idx(x);                                                    \
+      auto f = V::sub(x, V::flt(k));                                         \
+      auto a = V::gat(t - 1, k), b = V::gat(t, k), c = V::gat(t + 1, k),     \
+           d = V::gat(t + 2, k);                                             \
+      auto e = V::add(d, V::mul(three, b));                                  \
+      auto c3 = V::div(V::sub(V::sub(e, a), V::mul(three, c)), six);         \
+      auto c2 = V::sub(V::mul(V::add(a, c), half), b);                       \
+      auto c1 = V::sub(c, V::div(V::add(V::add(a, a), e), six));             \
+      V::st(o + i,                                                           \
+            V::add(V::mul(V::add(V::mul(V::add(V::mul(c3, f), c2), f), c1),  \
+                          f),                                                \
+                   b));                                                      \
+    }                                                                        \
+    scalar::cubic(t, p, o, n, i);                                            \
+  }                                                                          \
+  template <typename S> ATTR void hermite(const S *t, const S *p, S *o,      \
+                                          std::size_t n) {                   \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto half = V::set(.5), onehalf = V::set(1.5), twohalf = V::set(2.5);    \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(p + i);                                                 \
+      auto k = V::idx(x);                                                    \
+      auto f = V::sub(x, V::flt(k));                                         \
+      auto a = V::gat(t - 1, k), b = V::gat(t, k), c = V::gat(t + 1, k),     \
+           d = V::gat(t + 2, k);                                             \
+      auto c1 = V::mul(V::sub(c, a), half);                                  \
+      auto c2 = V::sub(V::add(V::sub(a, V::mul(twohalf, b)), V::add(c, c)),  \
+                       V::mul(half, d));                                     \
+      auto c3 = V::add(V::mul(V::sub(d, a), half),                           \
+                       V::mul(V::sub(b, c), onehalf));                       \
+      V::st(o + i,                                                           \
+            V::add(V::mul(V::add(V::mul(V::add(V::mul(c3, f), c2), f), c1),  \
+                          f),                                                \
+                   b));                                                      \
+    }                                                                        \
+    scalar::hermite(t, p, o, n, i);                                          \
+  }                                                                          \
+  template <typename S> ATTR void sin2pi(const S *a, S *o, std::size_t n,    \
+                                         int q) {                            \
+    typedef vec<S> V;                                                        \
+    std::size_t i = 0;                                                       \
+    auto h = V::set(.5), nh = V::set(-.5);                                   \
+    typename V::T c[6];                                                      \
+    int nc = sin_terms[q];                                                   \
+    for (int k = 0; k < 6; k++)                                              \
+      c[k] = V::set((S)sin_coefs[q][k]);                                     \
+    for (; i + V::N <= n; i += V::N) {                                       \
+      auto x = V::ld(a + i);                                                 \
+      auto r = V::sub(x, V::rnd(x));                                         \
+      auto t = V::max(V::min(r, V::sub(h, r)), V::sub(nh, r));               \
+      auto t2 = V::mul(t, t);                                                \
+      auto p = c[nc - 1];                                                    \
+      for (int k = nc - 2; k >= 0; k--)                                      \
+        p = V::add(V::mul(p, t2), c[k]);                                     \
+      V::st(o + i, V::mul(p, t));                                            \
+    }                                                                        \
+    scalar::sin2pi(a, o, n, q, i);                                           \
+  }
+
+#define AURORA_SIMD_OPS(ATTR, PFX, SFX)                                      \
+  static ATTR T add(T a, T b) { return PFX##_add_##SFX(a, b); }              \
+  static ATTR T sub(T a, T b) { return PFX##_sub_##SFX(a, b); }              \
+  static ATTR T mul(T a, T b) { return PFX##_mul_##SFX(a, b); }              \
+  static ATTR T div(T a, T b) { return PFX##_div_##SFX(a, b); }              \
+  static ATTR T min(T a, T b) { return PFX##_min_##SFX(a, b); }              \
+  static ATTR T max(T a, T b) { return PFX##_max_##SFX(a, b); }
+
+#ifdef __clang__
+#define AURORA_SIMD_T(ISA) __attribute__((target(ISA)))
+#else
+// GCC would otherwise contract mul + add into FMA where available
+#define AURORA_SIMD_T(ISA)                                                   \
+  __attribute__((target(ISA), optimize("fp-contract=off")))
+#endif
+#define AURORA_SIMD_T_SSE2 AURORA_SIMD_T("sse2")
+#define AURORA_SIMD_T_AVX2 AURORA_SIMD_T("avx2")
+#define AURORA_SIMD_T_AVX512 AURORA_SIMD_T("avx512f")
+
+namespace sse2 {
+template <typename S> struct vec;
+template <> struct vec<float> {
+  typedef __m128 T;
+  enum { N = 4 };
+  static AURORA_SIMD_T_SSE2 T ld(const float *p) { return _mm_loadu_ps(p); }
+  static AURORA_SIMD_T_SSE2 void st(float *p, T a) { _mm_storeu_ps(p, a); }
+  static AURORA_SIMD_T_SSE2 T set(float a) { return _mm_set1_ps(a); }
+  static AURORA_SIMD_T_SSE2 T abs(T a) {
+    return _mm_andnot_ps(_mm_set1_ps(-0.f), a);
+  }
+  static AURORA_SIMD_T_SSE2 float sum(T a) {
+    a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    return _mm_cvtss_f32(_mm_add_ss(a, _mm_shuffle_ps(a, a, 1)));
+  }
+  // no gather instruction: lanes are loaded one by one
+  typedef __m128i I;
+  static AURORA_SIMD_T_SSE2 I idx(T a) { return _mm_cvttps_epi32(a); }
+  static AURORA_SIMD_T_SSE2 T flt(I i) { return _mm_cvtepi32_ps(i); }
+  static AURORA_SIMD_T_SSE2 T rnd(T a) { return flt(_mm_cvtps_epi32(a)); }
+  static AURORA_SIMD_T_SSE2 T gat(const float *b, I i) {
+    alignas(16) int32_t k[4];
+    _mm_store_si128((__m128i *)k, i);
+    return _mm_setr_ps(b[k[0]], b[k[1]], b[k[2]], b[k[3]]);
+  }
+  AURORA_SIMD_OPS(AURORA_SIMD_T_SSE2, _mm, ps)
+};
+template <> struct vec<double> {
+  typedef __m128d T;
+  enum { N = 2 };
+  static AURORA_SIMD_T_SSE2 T ld(const double *p) { return _mm_loadu_pd(p); }
+  static AURORA_SIMD_T_SSE2 void st(double *p, T a) { _mm_storeu_pd(p, a); }
+  static AURORA_SIMD_T_SSE2 T set(double a) { return _mm_set1_pd(a); }
+  static AURORA_SIMD_T_SSE2 T abs(T a) {
+    return _mm_andnot_pd(_mm_set1_pd(-0.), a);
+  }
+  static AURORA_SIMD_T_SSE2 double sum(T a) {
+    return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+  }
+  typedef __m128i I;
+  static AURORA_SIMD_T_SSE2 I idx(T a) { return _mm_cvttpd_epi32(a); }
+  static AURORA_SIMD_T_SSE2 T flt(I i) { return _mm_cvtepi32_pd(i); }
+  static AURORA_SIMD_T_SSE2 T rnd(T a) { return flt(_mm_cvtpd_epi32(a)); }
+  static AURORA_SIMD_T_SSE2 T gat(const double *b, I i) {
+    alignas(16) int32_t k[4];
+    _mm_store_si128((__m128i *)k, i);
+    return _mm_setr_pd(b[k[0]], b[k[1]]);
+  }
+  AURORA_SIMD_OPS(AURORA_SIMD_T_SSE2, _mm, pd)
+};
+AURORA_SIMD_KERNELS(AURORA_SIMD_T_SSE2)
+} // namespace sse2
+
+namespace avx2 {
+template <typename S> struct vec;
+template <> struct vec<float> {
+  typedef __m256 T;
+  enum { N = 8 };
+  static AURORA_SIMD_T_AVX2 T ld(const float *p) { return _mm256_loadu_ps(p); }
+  static AURORA_SIMD_T_AVX2 void st(float *p, T a) { _mm256_storeu_ps(p, a); }
+  static AURORA_SIMD_T_AVX2 T set(float a) { return _mm256_set1_ps(a); }
+  static AURORA_SIMD_T_AVX2 T abs(T a) {
+    return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a);
+  }
+  static AURORA_SIMD_T_AVX2 float sum(T a) {
+    __m128 h =
+        _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+    return _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+  }
+  typedef __m256i I;
+  static AURORA_SIMD_T_AVX2 I idx(T a) { return _mm256_cvttps_epi32(a); }
+  static AURORA_SIMD_T_AVX2 T flt(I i) { return _mm256_cvtepi32_ps(i); }
+  static AURORA_SIMD_T_AVX2 T rnd(T a) { return flt(_mm256_cvtps_epi32(a)); }
+  // masked form avoids the undefined source of the plain one
+  static AURORA_SIMD_T_AVX2 T gat(const float *b, I i) {
+    return _mm256_mask_i32gather_ps(
+        _mm256_setzero_ps(), b, i, _mm256_castsi256_ps(_mm256_set1_epi32(-1)),
+        4);
+  }
+  AURORA_SIMD_OPS(AURORA_SIMD_T_AVX2, _mm256, ps)
+};
+template <> struct vec<double> {
+  typedef __m256d T;
+  enum { N = 4 };
+  static AURORA_SIMD_T_AVX2 T ld(const double *p) {
+    return _mm256_loadu_pd(p);
+  }
+  static AURORA_SIMD_T_AVX2 void st(double *p, T a) { _mm256_storeu_pd(p, a); }
+  static AURORA_SIMD_T_AVX2 T set(double a) { return _mm256_set1_pd(a); }
+  static AURORA_SIMD_T_AVX2 T abs(T a) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.), a);
+  }
+  static AURORA_SIMD_T_AVX2 double sum(T a) {
+    __m128d h =
+        _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+  }
+  typedef __m128i I;
+  static AURORA_SIMD_T_AVX2 I idx(T a) { return _mm256_cvttpd_epi32(a); }
+  static AURORA_SIMD_T_AVX2 T flt(I i) { return _mm256_cvtepi32_pd(i); }
+  static AURORA_SIMD_T_AVX2 T rnd(T a) { return flt(_mm256_cvtpd_epi32(a)); }
+  static AURORA_SIMD_T_AVX2 T gat(const double *b, I i) {
+    return _mm256_mask_i32gather_pd(
+        _mm256_setzero_pd(), b, i,
+        _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+  }
+  AURORA_SIMD_OPS(AURORA_SIMD_T_AVX2, _mm256, pd)
+};
+AURORA_SIMD_KERNELS(AURORA_SIMD_T_AVX2)
+} // namespace avx2
+
+namespace avx512 {
+template <typename S> struct vec;
+template <> struct vec<float> {
+  typedef __m512 T;
+  enum { N = 16 };
+  static AURORA_SIMD_T_AVX512 T ld(const float *p) {
+    return _mm512_loadu_ps(p);
+  }
+  static AURORA_SIMD_T_AVX512 void st(float *p, T a) {
+    _mm512_storeu_ps(p, a);
+  }
+  static AURORA_SIMD_T_AVX512 T set(float a) { return _mm512_set1_ps(a); }
+  static AURORA_SIMD_T_AVX512 T abs(T a) { return _mm512_abs_ps(a); }
+  // masked extractions avoid the undefined source of the plain ones
+  static AURORA_SIMD_T_AVX512 float sum(T a) {
+    __m256d z = _mm256_setzero_pd();
+    __m512d d = _mm512_castps_pd(a);
+    __m256d h = _mm512_mask_extractf64x4_pd(z, 0xF, d, 0);
+    __m256d l = _mm512_mask_extractf64x4_pd(z, 0xF, d, 1);
+    return avx2::vec<float>::sum(
+        _mm256_add_ps(_mm256_castpd_ps(h), _mm256_castpd_ps(l)));
+  }
+  static AURORA_SIMD_T_AVX512 T add(T a, T b) { return _mm512_add_ps(a, b); }
+  static AURORA_SIMD_T_AVX512 T sub(T a, T b) { return _mm512_sub_ps(a, b); }
+  static AURORA_SIMD_T_AVX512 T mul(T a, T b) { return _mm512_mul_ps(a, b); }
+  static AURORA_SIMD_T_AVX512 T div(T a, T b) { return _mm512_div_ps(a, b); }
+  // masked forms avoid the undefined source operand of the plain ones
+  static AURORA_SIMD_T_AVX512 T min(T a, T b) {
+    return _mm512_mask_min_ps(a, 0xFFFF, a, b);
+  }
+  static AURORA_SIMD_T_AVX512 T max(T a, T b) {
+    return _mm512_mask_max_ps(a, 0xFFFF, a, b);
+  }
+  typedef __m512i I;
+  static AURORA_SIMD_T_AVX512 I idx(T a) {
+    return _mm512_mask_cvttps_epi32(_mm512_setzero_si512(), 0xFFFF, a);
+  }
+  static AURORA_SIMD_T_AVX512 T flt(I i) {
+    return _mm512_mask_cvtepi32_ps(_mm512_setzero_ps(), 0xFFFF, i);
+  }
+  static AURORA_SIMD_T_AVX512 T rnd(T a) {
+    return flt(_mm512_mask_cvtps_epi32(_mm512_setzero_si512(), 0xFFFF, a));
+  }
+  static AURORA_SIMD_T_AVX512 T gat(const float *b, I i) {
+    return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, i, b, 4);
+  }
+};
+template <> struct vec<double> {
+  typedef __m512d T;
+  enum { N = 8 };
+  static AURORA_SIMD_T_AVX512 T ld(const double *p) {
+    return _mm512_loadu_pd(p);
+  }
+  static AURORA_SIMD_T_AVX512 void st(double *p, T a) {
+    _mm512_storeu_pd(p, a);
+  }
+  static AURORA_SIMD_T_AVX512 T set(double a) { return _mm512_set1_pd(a); }
+  static AURORA_SIMD_T_AVX512 T abs(T a) { return _mm512_abs_pd(a); }
+  // masked extractions avoid the undefined source of the plain ones
+  static AURORA_SIMD_T_AVX512 double sum(T a) {
+    __m256d z = _mm256_setzero_pd();
+    return avx2::vec<double>::sum(
+        _mm256_add_pd(_mm512_mask_extractf64x4_pd(z, 0xF, a, 0),
+                      _mm512_mask_extractf64x4_pd(z, 0xF, a, 1)));
+  }
+  static AURORA_SIMD_T_AVX512 T add(T a, T b) { return _mm512_add_pd(a, b); }
+  static AURORA_SIMD_T_AVX512 T sub(T a, T b) { return _mm512_sub_pd(a, b); }
+  static AURORA_SIMD_T_AVX512 T mul(T a, T b) { return _mm512_mul_pd(a, b); }
+  static AURORA_SIMD_T_AVX512 T div(T a, T b) { return _mm512_div_pd(a, b); }
+  // masked forms avoid the undefined source operand of the plain ones
+  static AURORA_SIMD_T_AVX512 T min(T a, T b) {
+    return _mm512_mask_min_pd(a, 0xFF, a, b);
+  }
+  static AURORA_SIMD_T_AVX512 T max(T a, T b) {
+    return _mm512_mask_max_pd(a, 0xFF, a, b);
+  }
+  typedef __m256i I;
+  static AURORA_SIMD_T_AVX512 I idx(T a) {
+    return _mm512_mask_cvttpd_epi32(_mm256_setzero_si256(), 0xFF, a);
+  }
+  static AURORA_SIMD_T_AVX512 T flt(I i) {
+    return _mm512_mask_cvtepi32_pd(_mm512_setzero_pd(), 0xFF, i);
+  }
+  static AURORA_SIMD_T_AVX512 T rnd(T a) {
+    return flt(_mm512_mask_cvtpd_epi32(_mm256_setzero_si256(), 0xFF, a));
+  }
+  static AURORA_SIMD_T_AVX512 T gat(const double *b, I i) {
+    return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, i, b, 8);
+  }
+};
+AURORA_SIMD_KERNELS(AURORA_SIMD_T_AVX512)
+} // namespace avx512
+
+#define AURORA_SIMD_CALL(FN, ...)                                            \
+  if constexpr (is_vec<S>) {                                                 \
+    switch (selected()) {                                                    \
+    case SIMD_AVX512:                                                        \
+      return avx512::FN(__VA_ARGS__);                                        \
+    case SIMD_AVX2:                                                          \
+      return avx2::FN(__VA_ARGS__);                                          \
+    case SIMD_SSE2:                                                          \
+      return sse2::FN(__VA_ARGS__);                                          \
+    default:                                                                 \
+      break;                                                                 \
+    }                                                                        \
+  }                                                                          \
+  return scalar::FN(__VA_ARGS__)
+#else
+#define AURORA_SIMD_CALL(FN, ...) return scalar::FN(__VA_ARGS__)
+#endif
+/* \endcond */
+
+/** Instruction set query \n
+    returns the instruction set used by the vector kernels
+*/
+inline simd_isa isa() { return selected(); }
+
+/** Instruction set selection \n
+    i: instruction set to use (capped to what the CPU supports) \n
+    this is a global setting, not meant to be changed while
+    processing is running in other threads
+*/
+inline void isa(simd_isa i) { selected() = i < detect() ? i : detect(); }
+
+/** Vector addition: o = a + b */
+template <typename S>
+void add(const S *a, const S *b, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(add, a, b, o, n);
+}
+
+/** Vector-scalar addition: o = a + b */
+template <typename S> void add(const S *a, S b, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(add, a, b, o, n);
+}
+
+/** Vector multiplication: o = a * b */
+template <typename S>
+void mul(const S *a, const S *b, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(mul, a, b, o, n);
+}
+
+/** Vector-scalar multiplication: o = a * b */
+template <typename S> void mul(const S *a, S b, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(mul, a, b, o, n);
+}
+
+/** Vector multiply-add: o = a * b + c */
+template <typename S>
+void muladd(const S *a, const S *b, const S *c, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(muladd, a, b, c, o, n);
+}
+
+/** Vector-scalar multiply-add: o = a * b + c */
+template <typename S>
+void muladd(const S *a, S b, const S *c, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(muladd, a, b, c, o, n);
+}
+
+/** Scale and offset: o = a * scal + offs */
+template <typename S>
+void scaloffs(const S *a, S scal, S offs, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(scaloffs, a, scal, offs, o, n);
+}
+
+/** Absolute value: o = |a| */
+template <typename S> void abs(const S *a, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(abs, a, o, n);
+}
+
+/** Clipping: o = min(max(a, lo), hi) */
+template <typename S>
+void clip(const S *a, S lo, S hi, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(clip, a, lo, hi, o, n);
+}
+
+/** Fast tanh approximation: o = tanha(a) */
+template <typename S> void tanh(const S *a, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(tanh, a, o, n);
+}
+
+/** Peak absolute value: returns max |a| (0 for an empty vector,
+    NaN if any element is NaN)
+*/
+template <typename S> S peak(const S *a, std::size_t n) {
+  AURORA_SIMD_CALL(peak, a, n);
+}
+
+/** Dot product: returns sum of a * b \n
+    unlike the other kernels, vector forms add the products in
+    a different order from the scalar one, so results may differ
+    in the last bits across instruction sets
+*/
+template <typename S> S dot(const S *a, const S *b, std::size_t n) {
+  AURORA_SIMD_CALL(dot, a, b, n);
+}
+
+/** Linear interpolation gather: o = t[k] + f * (t[k+1] - t[k]) \n
+    t: table, readable from t[0] to t[k+1] \n
+    p: positions (k and f are the integral and fractional parts,
+    no bounds check, p >= 0)
+*/
+template <typename S>
+void lerp(const S *t, const S *p, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(lerp, t, p, o, n);
+}
+
+/** Cubic (Lagrange) interpolation gather \n
+    t: table, readable from t[k-1] to t[k+2] \n
+    p: positions (no bounds check, p >= 0)
+*/
+template <typename S>
+void cubic(const S *t, const S *p, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(cubic, t, p, o, n);
+}
+
+/** Hermite (Catmull-Rom) interpolation gather \n
+    t: table, readable from t[k-1] to t[k+2] \n
+    p: positions (no bounds check, p >= 0)
+*/
+template <typename S>
+void hermite(const S *t, const S *p, S *o, std::size_t n) {
+  AURORA_SIMD_CALL(hermite, t, p, o, n);
+}
+
+/** Fast sine: o = sinpoly(a, q) = sin(2 pi a) \n
+    a: phases in cycles \n
+    q: accuracy (SIN_FAST, SIN_MEDIUM, SIN_BEST)
+*/
+template <typename S>
+void sin2pi(const S *a, S *o, std::size_t n, sin_quality q = SIN_MEDIUM) {
+  AURORA_SIMD_CALL(sin2pi, a, o, n, q);
+}
+
+} // namespace simd
+} // namespace Aurora
+
+#undef AURORA_SIMD_CALL
+#undef AURORA_SIMD_SCALAR_KERNELS
+#ifdef AURORA_SIMD_X86
+#undef AURORA_SIMD_KERNELS
+#undef AURORA_SIMD_OPS
+#undef AURORA_SIMD_T
+#undef AURORA_SIMD_T_SSE2
+#undef AURORA_SIMD_T_AVX2
+#undef AURORA_SIMD_T_AVX512
+#endif
+
+#endif // _AURORA_SIMD_
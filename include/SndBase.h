@@ -29,44 +29,586 @@
 #ifndef _AURORA_SNDBASE_
 #define _AURORA_SNDBASE_
 
+#include "Profile.h"
+#include "Simd.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <new>
 #include <numeric>
+#include <type_traits>
 #include <vector>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+#ifndef AURORA_ALIGN
+#define AURORA_ALIGN 64
+#endif
+
+#if defined(AURORA_RT_SAFE) && !defined(NDEBUG) && !defined(AURORA_RT_GUARD)
+#define AURORA_RT_GUARD
+#endif
+
+#if defined(__x86_64__) || defined(__SSE__)
+#define AURORA_FTZ_SSE
+#include <xmmintrin.h>
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define AURORA_FTZ_ARM
+#endif
+
 namespace Aurora {
 const int def_vsize = 64;
 const double def_sr = 44100.;
 const double twopi = 2 * M_PI;
+const std::size_t def_align = AURORA_ALIGN;
+
+/** aligned_allocator class \n
+    Allocator returning memory aligned to A bytes \n
+    T: value type \n
+    A: alignment in bytes (power of two, defaults to AURORA_ALIGN)
+*/
+template <typename T, std::size_t A = def_align> struct aligned_allocator {
+  static_assert(A && !(A & (A - 1)), "alignment must be a power of two");
+  static_assert(A >= alignof(T), "alignment must be at least alignof(T)");
+  typedef T value_type;
+  template <typename U> struct rebind {
+    typedef aligned_allocator<U, A> other;
+  };
+
+  aligned_allocator() noexcept {};
+  template <typename U>
+  aligned_allocator(const aligned_allocator<U, A> &) noexcept {};
+
+  T *allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+      throw std::bad_array_new_length();
+    return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(A)));
+  }
+
+  void deallocate(T *p, std::size_t n) noexcept {
+    (void)n;
+    ::operator delete(p, std::align_val_t(A));
+  }
+
+  template <typename U>
+  bool operator==(const aligned_allocator<U, A> &) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const aligned_allocator<U, A> &) const noexcept {
+    return false;
+  }
+};
+
+/** aligned_vector type \n
+    std::vector using aligned_allocator \n
+    S: sample type \n
+    A: alignment in bytes
+*/
+template <typename S, std::size_t A = def_align>
+using aligned_vector = std::vector<S, aligned_allocator<S, A>>;
+
+/** sig_vector type \n
+    vector type of object signals and delay lines \n
+    S: sample type \n
+    an aligned_vector, unless AURORA_STD_VECTOR is defined (before
+    including any Aurora header), which makes it a plain std::vector,
+    so that client code written for the std::vector interface keeps
+    compiling while it is migrated (with unaligned signals)
+*/
+#ifdef AURORA_STD_VECTOR
+template <typename S> using sig_vector = std::vector<S>;
+#else
+template <typename S> using sig_vector = aligned_vector<S>;
+#endif
+
+#ifdef AURORA_RT_GUARD
+/** Real-time size limit hook \n
+    called with the requested and the available size when a size
+    is limited to preallocated memory (AURORA_RT_GUARD builds); the
+    default reports the request and fails an assertion
+*/
+inline void (*rt_limit_hook)(std::size_t, std::size_t) =
+    [](std::size_t n, std::size_t m) {
+      std::fprintf(stderr, "Aurora: size %zu limited to %zu\n", n, m);
+      assert(n <= m);
+    };
+#endif
+
+/** Vector resizing on the processing path \n
+    v: vector \n
+    n: new size \n
+    returns the new size \n
+    if AURORA_RT_SAFE is defined, the size is limited to the
+    vector capacity (e.g. set by prealloc()), so that it never
+    allocates memory; callers can compare the result with n, and
+    AURORA_RT_GUARD builds also call rt_limit_hook
+*/
+template <typename V> std::size_t rt_resize(V &v, std::size_t n) {
+#ifdef AURORA_RT_SAFE
+  if (n > v.capacity()) {
+#ifdef AURORA_RT_GUARD
+    rt_limit_hook(n, v.capacity());
+#endif
+    n = v.capacity();
+  }
+#endif
+  v.resize(n);
+  return v.size();
+}
+
+/** Real-time allocation hook \n
+    called with the requested size when memory is allocated
+    inside a processing call (AURORA_RT_GUARD builds, see RtGuard.h);
+    the default reports the allocation and aborts
+*/
+inline void (*rt_alloc_hook)(std::size_t) = [](std::size_t n) {
+  std::fprintf(stderr, "Aurora: %zu-byte allocation in processing call\n", n);
+  std::abort();
+};
+
+/** Processing call depth of the current thread
+ */
+inline std::size_t &rt_depth() {
+  thread_local std::size_t depth = 0;
+  return depth;
+}
+
+/** rt_scope class \n
+    Marks a processing call for the allocation guard, which is
+    active in AURORA_RT_SAFE debug builds (AURORA_RT_GUARD) \n
+    objects are placed at the start of processing loops, and
+    can also be used to cover a whole audio callback
+*/
+struct rt_scope {
+#ifdef AURORA_RT_GUARD
+  rt_scope() { rt_depth()++; }
+  ~rt_scope() { rt_depth()--; }
+#else
+  rt_scope() {}
+#endif
+};
+
+/* \cond */
+#if defined(AURORA_FTZ_SSE)
+const std::uint64_t ftz_bits = 0x8040; // MXCSR FTZ | DAZ
+inline std::uint64_t fp_mode() { return _mm_getcsr(); }
+inline void fp_mode(std::uint64_t m) { _mm_setcsr((unsigned int)m); }
+#elif defined(AURORA_FTZ_ARM)
+const std::uint64_t ftz_bits = 1 << 24; // FPCR FZ
+inline std::uint64_t fp_mode() {
+  std::uint64_t m;
+  __asm__ __volatile__("mrs %0, fpcr" : "=r"(m));
+  return m;
+}
+inline void fp_mode(std::uint64_t m) {
+  __asm__ __volatile__("msr fpcr, %0" : : "r"(m));
+}
+#else
+const std::uint64_t ftz_bits = 0;
+inline std::uint64_t fp_mode() { return 0; }
+inline void fp_mode(std::uint64_t) {}
+#endif
+/* \endcond */
+
+/** Denormal flushing query \n
+    returns true if the current thread flushes denormals to zero
+*/
+inline bool ftz() { return ftz_bits && (fp_mode() & ftz_bits) == ftz_bits; }
+
+/** ftz_scope class \n
+    Sets the current thread to flush denormal results and inputs
+    to zero (FTZ/DAZ) for the lifetime of the object, restoring
+    the previous mode on exit. Decaying feedback state (delay
+    lines, filters) otherwise runs into denormals, which are very
+    slow to compute on most processors. The mode is per thread:
+    Executor workers take it from the thread running the graph.
+    It has no effect on processors other than x86-64 and AArch64.
+*/
+class ftz_scope {
+  std::uint64_t old;
+
+public:
+  /** Constructor \n
+      on: flush denormals (false leaves the mode unchanged)
+  */
+  ftz_scope(bool on = true) : old(fp_mode()) {
+    if (on)
+      fp_mode(old | ftz_bits);
+  }
+  ~ftz_scope() { fp_mode(old); }
+  ftz_scope(const ftz_scope &) = delete;
+  ftz_scope &operator=(const ftz_scope &) = delete;
+};
+
+/** span class \n
+    non-owning view of contiguous samples \n
+    T: element type (const S for inputs, S for outputs) \n
+    vectors convert implicitly to input spans only; an output
+    span over a vector needs to be constructed explicitly
+*/
+template <typename T> class span {
+  typedef typename std::remove_const<T>::type U;
+  T *ptr;
+  std::size_t len;
+
+public:
+  /** Constructor \n
+      p: data pointer \n
+      n: number of elements
+  */
+  span(T *p = nullptr, std::size_t n = 0) : ptr(p), len(n){};
+
+  /** Constructor \n
+      v: vector to view (input spans only)
+  */
+  template <typename A, typename X = T,
+            typename std::enable_if<std::is_const<X>::value, int>::type = 0>
+  span(const std::vector<U, A> &v) : ptr(v.data()), len(v.size()){};
+
+  /** Constructor \n
+      v: vector to view
+  */
+  template <typename A>
+  explicit span(std::vector<U, A> &v) : ptr(v.data()), len(v.size()){};
+
+  /** Constructor \n
+      s: output span to view as input
+  */
+  template <typename X = T,
+            typename std::enable_if<std::is_const<X>::value, int>::type = 0>
+  span(const span<U> &s) : ptr(s.data()), len(s.size()){};
+
+  T *data() const { return ptr; }
+  std::size_t size() const { return len; }
+  bool empty() const { return len == 0; }
+  T *begin() const { return ptr; }
+  T *end() const { return ptr + len; }
+  T &operator[](std::size_t n) const { return ptr[n]; }
+
+  /** Leading subspan \n
+      n: number of elements (clamped to the span size)
+  */
+  span first(std::size_t n) const { return span(ptr, n < len ? n : len); }
+};
+
+/** Block quietness test \n
+    s: signal \n
+    th: threshold (absolute amplitude) \n
+    returns true if all samples of s are within the threshold
+    (NaN samples never are) \n
+    the first and last samples are checked before the block is
+    scanned, in short segments, so that the test normally ends
+    at once for a non-silent signal
+*/
+template <typename S> bool quiet(span<const S> s, S th) {
+  constexpr std::size_t seg = 32;
+  std::size_t n = s.size();
+  if (n && !(rect(s[0]) <= th && rect(s[n - 1]) <= th))
+    return false;
+  for (std::size_t i = 0; i < n; i += seg)
+    if (!(simd::peak(s.data() + i, n - i < seg ? n - i : seg) <= th))
+      return false;
+  return true;
+}
+
+/** Block silence test \n
+    s: signal \n
+    returns true if all samples of s are zero
+*/
+template <typename S> bool silent(span<const S> s) { return quiet(s, S(0)); }
+
+/** Tail class \n
+    silence-tail detection for objects with feedback state \n
+    S: sample type \n
+    once the state and output of an object have decayed to
+    within a threshold, the object clears its state and goes
+    idle. While idle, input blocks within the threshold produce
+    silent output with no processing; the first block above it
+    wakes the object up. Detection is off (threshold < 0) by
+    default, and is turned on per object with its tail() method.
+*/
+template <typename S> class Tail {
+  S th;
+  bool idl;
+
+public:
+  Tail() : th(-1), idl(false){};
+
+  /** Threshold setting \n
+      t: threshold (absolute amplitude, < 0 turns detection off)
+  */
+  void threshold(S t) {
+    th = t;
+    idl = false;
+  }
+
+  /** Threshold query
+   */
+  S threshold() const { return th; }
+
+  /** Detection query
+   */
+  bool on() const { return th >= 0; }
+
+  /** Idle state query
+   */
+  bool idle() const { return idl; }
+
+  /** Idle state setting \n
+      b: idle state
+  */
+  void idle(bool b) { idl = b && on(); }
+
+  /** Signal test \n
+      s: signal \n
+      returns true if s is within the threshold
+  */
+  bool quiet(span<const S> s) const { return Aurora::quiet(s, th); }
+
+  /** State test \n
+      st: state variables \n
+      n: number of state variables \n
+      returns true if all state is within the threshold
+  */
+  template <typename T> bool quiet(const T *st, std::size_t n) const {
+    for (std::size_t i = 0; i < n; i++)
+      if (!(st[i] <= th && st[i] >= -th))
+        return false;
+    return true;
+  }
+
+  /** Block skip test \n
+      in: block input \n
+      returns true if the object is idle and the input is
+      within the threshold (the object wakes up otherwise)
+  */
+  bool skip(span<const S> in) {
+    if (idl && !quiet(in))
+      idl = false;
+    return idl;
+  }
+};
+
+/** Smooth class \n
+    control-rate parameter smoothing \n
+    S: sample type \n
+    when on, a parameter change is ramped across the next block,
+    linearly or exponentially, rather than applied at once.
+    Coefficients are recomputed from the ramped parameters every
+    k samples and linearly interpolated in between, so that
+    changes are free of zipper noise at a fraction of the cost
+    of per-sample coefficient updates.
+*/
+template <typename S> class Smooth {
+  std::size_t k;
+  bool ex, set;
+
+public:
+  Smooth() : k(0), ex(false), set(false){};
+
+  /** Smoothing setting \n
+      kk: coefficient update period in samples (0 turns smoothing off) \n
+      e: exponential (true) or linear (false) ramps
+  */
+  void rate(std::size_t kk, bool e = false) {
+    k = kk;
+    ex = e;
+  }
+
+  /** Update period query
+   */
+  std::size_t rate() const { return k; }
+
+  /** Ramp test \n
+      returns true if a parameter change should be ramped, i.e. if
+      smoothing is on and parameters were set before (the first
+      setting is always applied at once)
+  */
+  bool ramp() {
+    bool r = k && set;
+    set = true;
+    return r;
+  }
+
+  /** Ramp value \n
+      a: start value \n
+      b: end value \n
+      t: ramp position (0 - 1) \n
+      exponential ramps between values of different signs or
+      involving zero fall back to linear
+  */
+  S at(S a, S b, double t) const {
+    if (t >= 1)
+      return b;
+    if (ex && a * b > 0)
+      return (S)(a * std::pow((double)b / a, t));
+    return (S)(a + (b - a) * t);
+  }
+};
 
 /** SndBase class \n
     Aurora Library base class \n
     S: sample type
 */
 template <typename S = float> class SndBase {
-  std::vector<S> sig;
-  
+  sig_vector<S> sig;
+  bool sil;
+#ifdef AURORA_PROFILE
+  prof_probe prb;
+#endif
+
 protected:
-  const std::vector<S> &process(std::function<S()> f, std::size_t sz) {
+  /** Profiling scope \n
+      returns a scope timing the current processing call
+      (AURORA_PROFILE builds, see Profile.h; no-op otherwise)
+  */
+  prof_scope profile() const {
+#ifdef AURORA_PROFILE
+    return prof_scope(prb, this, typeid(*this));
+#else
+    return prof_scope();
+#endif
+  }
+
+  /** Processing loop \n
+      f: sample generating callable, invoked once per sample \n
+      sz: new vector size (0 keeps the current size) \n
+      the callable type is a template parameter, so that
+      the per-sample call can be inlined by the compiler
+  */
+  template <typename F>
+  const sig_vector<S> &process(F &&f, std::size_t sz) {
+    rt_scope guard;
+    auto prof = profile();
     if (sz)
       vsize(sz);
+    sil = false;
     for (auto &s : sig)
       s = f();
     return sig;
   }
 
-  std::vector<S> &get_sig() { return sig; };
+  /** Processing loop (type-erased) \n
+      f: sample generating function \n
+      sz: new vector size (0 keeps the current size) \n
+      kept for code explicitly passing a std::function
+  */
+  const sig_vector<S> &process(const std::function<S()> &f, std::size_t sz) {
+    rt_scope guard;
+    auto prof = profile();
+    if (sz)
+      vsize(sz);
+    sil = false;
+    for (auto &s : sig)
+      s = f();
+    return sig;
+  }
+
+  /** Processing loop (caller output) \n
+      f: sample generating callable, invoked once per sample \n
+      out: caller-provided output \n
+      returns out
+  */
+  template <typename F> span<S> process(F &&f, span<S> out) {
+    rt_scope guard;
+    auto prof = profile();
+    sil = false;
+    for (auto &s : out)
+      s = f();
+    return out;
+  }
+
+  /** Processing loop (parameter ramp) \n
+      sm: smoothing settings \n
+      out: caller-provided output \n
+      c: current coefficients, updated to the end of the ramp \n
+      cfs: callable cfs(t, cn) placing the coefficients at ramp
+      position t (0 - 1] in cn \n
+      f: sample generating callable f(i, c), for sample i with
+      coefficients c \n
+      returns out
+  */
+  template <std::size_t M, typename CF, typename F>
+  span<S> process(const Smooth<S> &sm, span<S> out, double (&c)[M], CF &&cfs,
+                  F &&f) {
+    rt_scope guard;
+    auto prof = profile();
+    std::size_t n = out.size(), k = sm.rate();
+    double cn[M], dc[M];
+    sil = false;
+    for (std::size_t j = 0; j < n; j += k) {
+      std::size_t e = j + k < n ? j + k : n;
+      std::copy(c, c + M, cn);
+      cfs((double)e / n, cn);
+      for (std::size_t m = 0; m < M; m++)
+        dc[m] = (cn[m] - c[m]) / (e - j);
+      for (std::size_t i = j; i < e - 1; i++) {
+        for (std::size_t m = 0; m < M; m++)
+          c[m] += dc[m];
+        out[i] = f(i, c);
+      }
+      std::copy(cn, cn + M, c);
+      out[e - 1] = f(e - 1, c);
+    }
+    return out;
+  }
+
+  /** Object output as a span \n
+      sz: new vector size (0 keeps the current size) \n
+      used by the vector API to run the span API in place
+  */
+  span<S> sig_span(std::size_t sz) {
+    if (sz)
+      vsize(sz);
+    sil = false;
+    return span<S>(sig);
+  }
+
+  /** Silent output \n
+      out: output block \n
+      returns out, zeroed, and flags the block as silent
+  */
+  span<S> mute(span<S> out) {
+    std::fill(out.begin(), out.end(), 0);
+    sil = true;
+    return out;
+  }
+
+  /** Silence flag setting \n
+      b: true if the last block produced was silent
+  */
+  void silent(bool b) { sil = b; }
+
+  sig_vector<S> &get_sig() { return sig; };
 
 public:
   /** Constructor \n
       vsize: signal vector size
   */
-  SndBase(std::size_t vsize = def_vsize) : sig(vsize){};
+  SndBase(std::size_t vsize = def_vsize) : sig(vsize), sil(false){};
+
+#ifdef AURORA_PROFILE
+  virtual ~SndBase() {}
+#endif
+
+  /** Silence flag query \n
+      returns true if the last block produced by the object was
+      found to be silent (all zeros) and its computation skipped;
+      false if it was computed, which does not exclude silence. A
+      pool of voices, for instance, can use this to leave out
+      voices that have finished.
+  */
+  bool silent() const { return sil; }
 
   /** Vector size query \n
       returns the object vector size
@@ -74,18 +616,21 @@ public:
   std::size_t vsize() const { return sig.size(); }
 
   /** Vector size setting \n
-      n: new vector size
+      n: new vector size \n
+      returns the vector size set, limited to the preallocated size
+      if AURORA_RT_SAFE is defined
   */
-  void vsize(std::size_t n) { sig.resize(n); }
+  std::size_t vsize(std::size_t n) { return rt_resize(sig, n); }
 
   /** Vector access \n
       returns the object vector
   */
-  const std::vector<S> &vector() const { return sig; }
+  const sig_vector<S> &vector() const { return sig; }
 
   /** Preallocate vector memory \n
       size: size of vector to reserve in memory \n
-      this method does not change the vector size.
+      this method does not change the vector size. If AURORA_RT_SAFE
+      is defined, it sets the maximum vector size.
   */
   void prealloc(std::size_t size) { sig.reserve(size); }
 
@@ -98,18 +643,181 @@ public:
   /** Sets all output samples to zero \n
       returns the object vector
   */
-  const std::vector<S> &clear() {
+  const sig_vector<S> &clear() {
     std::fill(sig.begin(), sig.end(), 0);
     return sig;
   }
 };
 
+/** channels type \n
+    N read-only channel views, used as multichannel signal \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N>
+using channels = std::array<span<const S>, N>;
+
+/** SndBaseN class \n
+    Multichannel base class, holding N planar channels \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N> class SndBaseN {
+  static_assert(N > 0, "at least one channel is needed");
+  sig_vector<S> sig;
+  std::size_t vs;
+#ifdef AURORA_PROFILE
+  prof_probe prb;
+#endif
+
+protected:
+  /** Profiling scope \n
+      returns a scope timing the current processing call
+      (AURORA_PROFILE builds, see Profile.h; no-op otherwise)
+  */
+  prof_scope profile() const {
+#ifdef AURORA_PROFILE
+    return prof_scope(prb, this, typeid(*this));
+#else
+    return prof_scope();
+#endif
+  }
+
+  /** Processing loop \n
+      f: frame processing callable, invoked once per sample
+      as f(x, y), with x holding the N input samples and y
+      receiving the N output samples \n
+      in: input channels \n
+      sz: new vector size \n
+      returns the output channels \n
+      channels are transposed to and from frames in short tiles,
+      so that the callable can process them as contiguous lanes
+  */
+  template <typename F>
+  channels<S, N> process(F &&f, const channels<S, N> &in, std::size_t sz) {
+    constexpr std::size_t T = 16;
+    S x[T][N], y[T][N];
+    const S *ip[N];
+    rt_scope guard;
+    auto prof = profile();
+    vsize(sz);
+    for (std::size_t c = 0; c < N; c++)
+      ip[c] = in[c].data();
+    S *o = sig.data();
+    for (std::size_t n = 0; n < vs; n += T) {
+      std::size_t t = vs - n < T ? vs - n : T;
+      for (std::size_t c = 0; c < N; c++)
+        for (std::size_t k = 0; k < t; k++)
+          x[k][c] = ip[c][n + k];
+      for (std::size_t k = 0; k < t; k++)
+        f(x[k], y[k]);
+      for (std::size_t c = 0; c < N; c++)
+        for (std::size_t k = 0; k < t; k++)
+          o[c * vs + n + k] = y[k][c];
+    }
+    return signal();
+  }
+
+  /** Channel data \n
+      c: channel number \n
+      returns a pointer to the output of channel c
+  */
+  S *get_chn(std::size_t c) { return sig.data() + c * vs; }
+
+  /** Shortest channel size \n
+      in: multichannel input
+  */
+  static std::size_t minsize(const channels<S, N> &in) {
+    std::size_t sz = in[0].size();
+    for (auto &c : in)
+      sz = c.size() < sz ? c.size() : sz;
+    return sz;
+  }
+
+public:
+  /** Constructor \n
+      vsize: signal vector size (per channel)
+  */
+  SndBaseN(std::size_t vsize = def_vsize) : sig(N * vsize), vs(vsize){};
+
+#ifdef AURORA_PROFILE
+  virtual ~SndBaseN() {}
+#endif
+
+  /** Number of channels
+   */
+  static constexpr std::size_t nchnls() { return N; }
+
+  /** Vector size query \n
+      returns the object vector size (per channel)
+  */
+  std::size_t vsize() const { return vs; }
+
+  /** Vector size setting \n
+      n: new vector size (per channel) \n
+      returns the vector size set, limited to the preallocated size
+      if AURORA_RT_SAFE is defined
+  */
+  std::size_t vsize(std::size_t n) {
+    vs = rt_resize(sig, N * n) / N;
+    sig.resize(N * vs);
+    return vs;
+  }
+
+  /** Channel access \n
+      c: channel number \n
+      returns a view of channel c
+  */
+  span<const S> channel(std::size_t c) const {
+    return span<const S>(sig.data() + c * vs, vs);
+  }
+
+  /** Signal access \n
+      returns views of all channels
+  */
+  channels<S, N> signal() const {
+    channels<S, N> chn;
+    for (std::size_t c = 0; c < N; c++)
+      chn[c] = channel(c);
+    return chn;
+  }
+
+  /** Vector access \n
+      returns the planar object vector (N * vsize() samples)
+  */
+  const sig_vector<S> &vector() const { return sig; }
+
+  /** Preallocate vector memory \n
+      size: size of vector to reserve in memory (per channel) \n
+      this method does not change the vector size. If AURORA_RT_SAFE
+      is defined, it sets the maximum vector size.
+  */
+  void prealloc(std::size_t size) { sig.reserve(N * size); }
+
+  /** Copy interleaved sample data to out \n
+      out: buffer receiving the audio data \n
+      output buffer needs to have space for N * vsize() samples.
+  */
+  void copy_out(S *out) {
+    for (std::size_t n = 0; n < vs; n++)
+      for (std::size_t c = 0; c < N; c++)
+        *out++ = sig[c * vs + n];
+  }
+
+  /** Sets all output samples to zero \n
+      returns the output channels
+  */
+  channels<S, N> clear() {
+    std::fill(sig.begin(), sig.end(), 0);
+    return signal();
+  }
+};
+
 /** Buff class \n
     circular buffer \n
     S: sample type
 */
 template <typename S> class Buff : public SndBase<S> {
-  using SndBase<S>::get_sig;
   using SndBase<S>::vsize;
   std::vector<S> b;
   std::size_t wp, rp;
@@ -135,9 +843,10 @@ public:
   /** Buffer input \n
       in: audio input \n
   */
-  void operator()(const std::vector<S> &in) {
+  void operator()(span<const S> in) {
     if (b.size() < vsize())
-      b.resize(vsize());
+      rt_resize(b, vsize());
+    in = in.first(b.size());
     std::size_t end = in.size() + wp;
     if (end < b.size()) {
       std::copy(in.begin(), in.end(), b.begin() + wp);
@@ -151,21 +860,29 @@ public:
   }
 
   /** Buffer output \n
-      returns audio from buffer \n
+      out: caller-provided output, filled from the buffer \n
+      returns out
   */
-  const std::vector<S> &operator()() {
-    auto &o = get_sig();
-    std::size_t end = vsize() + rp;
+  span<S> operator()(span<S> out) {
+    std::size_t end = out.size() + rp;
     if (end < b.size()) {
-      std::copy(b.begin() + rp, b.begin() + end, o.begin());
+      std::copy(b.begin() + rp, b.begin() + end, out.begin());
       rp = end;
     } else {
       std::size_t ovflw = end - b.size();
-      std::copy(b.begin() + rp, b.end(), o.begin());
-      std::copy(b.begin(), b.begin() + ovflw, o.end() - ovflw);
+      std::copy(b.begin() + rp, b.end(), out.begin());
+      std::copy(b.begin(), b.begin() + ovflw, out.end() - ovflw);
       rp = ovflw;
     }
-    return o;
+    return out;
+  }
+
+  /** Buffer output \n
+      returns audio from buffer \n
+  */
+  const sig_vector<S> &operator()() {
+    (*this)(this->sig_span(0));
+    return this->vector();
   }
 };
 
@@ -174,10 +891,36 @@ template<typename S> S nop(S a, S b) { return (S) 0; }
 /** BinOp class \n
     Binary operations \n
     OP: binary operation function \n
-    S: sample type
+    S: sample type \n
+    plus and times use vectorised kernels, and skip computation
+    when their result is known to be silent (both inputs silent
+    for plus; for times, a silent signal scaled by a finite
+    scalar, since 0 * Inf and 0 * NaN give NaN)
 */
  template <typename S, S (*OP)(S, S)> class BinOp : public SndBase<S> {
   using SndBase<S>::process;
+  static constexpr bool vec = OP == plus<S> || OP == times<S>;
+
+  template <typename T> span<S> kernel(const S *a, T b, span<S> out) {
+    rt_scope guard;
+    auto prof = this->profile();
+    this->silent(false);
+    if (OP == plus<S>)
+      simd::add(a, b, out.data(), out.size());
+    else
+      simd::mul(a, b, out.data(), out.size());
+    return out;
+  }
+
+  /* silent results of plus and times */
+  static bool zero(S a, span<const S> s) {
+    return OP == times<S> ? std::isfinite(a) && silent(s)
+                          : a == 0 && silent(s);
+  }
+
+  static bool zero(span<const S> s1, span<const S> s2) {
+    return OP == plus<S> && silent(s1) && silent(s2);
+  }
 
 public:
   /** Constructor \n
@@ -186,32 +929,52 @@ public:
   BinOp(std::size_t vsize = def_vsize) : SndBase<S>(vsize){};
 
   /** Binary operation \n
+      out: caller-provided output \n
       a: scalar input \n
       s: signal input \n
-      returns reference to object signal vector
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(S a, const std::vector<S> &s) {
+  span<S> operator()(span<S> out, S a, span<const S> s) {
+    out = out.first(s.size());
+    if constexpr (vec) {
+      if (zero(a, s))
+        return this->mute(out);
+      return kernel(s.data(), a, out);
+    }
     std::size_t n = 0;
-    return process([&]() { return OP(a, s[n++]); }, s.size());
+    return process([&]() { return OP(a, s[n++]); }, out);
   }
 
   /** Binary operation \n
+      out: caller-provided output \n
       s: signal input \n
       a: scalar input \n
-      returns reference to object signal vector
+      returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &s, S a) {
+  span<S> operator()(span<S> out, span<const S> s, S a) {
+    out = out.first(s.size());
+    if constexpr (vec) {
+      if (zero(a, s))
+        return this->mute(out);
+      return kernel(s.data(), a, out);
+    }
     std::size_t n = 0;
-    return process([&]() -> S { return OP(a, s[n++]); }, s.size());
+    return process([&]() -> S { return OP(a, s[n++]); }, out);
   }
 
   /** Binary operation \n
+      out: caller-provided output \n
       s1: signal input 1 \n
       s2: signal input 2 \n
-      returns reference to object signal vector
+      returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &s1,
-                                   const std::vector<S> &s2) {
+  span<S> operator()(span<S> out, span<const S> s1, span<const S> s2) {
+    out = out.first(s1.size() < s2.size() ? s1.size() : s2.size());
+    if constexpr (vec) {
+      if (zero(s1.first(out.size()), s2.first(out.size())))
+        return this->mute(out);
+      return kernel(s1.data(), s2.data(), out);
+    }
     std::size_t n = 0;
     return process(
         [&]() -> S {
@@ -219,34 +982,91 @@ public:
           n++;
           return s;
         },
-        s1.size() < s2.size() ? s1.size() : s2.size());
+        out);
+  }
+
+  /** Binary operation \n
+      a: scalar input \n
+      s: signal input \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(S a, span<const S> s) {
+    (*this)(this->sig_span(s.size()), a, s);
+    return this->vector();
+  }
+
+  /** Binary operation \n
+      s: signal input \n
+      a: scalar input \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> s, S a) {
+    (*this)(this->sig_span(s.size()), s, a);
+    return this->vector();
+  }
+
+  /** Binary operation \n
+      s1: signal input 1 \n
+      s2: signal input 2 \n
+      returns reference to object signal vector
+  */
+  const sig_vector<S> &operator()(span<const S> s1, span<const S> s2) {
+    (*this)(this->sig_span(s1.size() < s2.size() ? s1.size() : s2.size()), s1,
+            s2);
+    return this->vector();
   }
 };
 
 /** Mix class \n
-    n-signal mixer \n
-    S: sample type
+    n-signal mixer (vectorised) \n
+    S: sample type \n
+    all inputs are mixed in a single pass over the output, which
+    is processed in tiles small enough to stay in cache while each
+    input is added to it. Silent inputs (with finite gains) are
+    left out.
 */
 template <typename S = float> class Mix : public SndBase<S> {
-  using SndBase<S>::process;
-  using SndBase<S>::get_sig;
+  static constexpr std::size_t tile = 256;
 
-  const std::vector<S> &mix(std::vector<S> &out, const std::vector<S> &in) {
-    std::size_t n = 0;
-    return process(
-        [&]() {
-          auto s = out[n] + in[n];
-          n++;
-          return s;
-        },
-        in.size() < this->vsize() ? in.size() : this->vsize());
-  }
+  static std::size_t minsize(std::size_t n) { return n; }
 
   template <typename... Ts>
-  const std::vector<S> &mix(std::vector<S> &out, const std::vector<S> &in,
-                            Ts... args) {
-    mix(out, in);
-    return mix(out, args...);
+  static std::size_t minsize(std::size_t n, span<const S> in,
+                             const Ts &... args) {
+    return minsize(in.size() < n ? in.size() : n, args...);
+  }
+
+  /* sum of inputs, g: gains (if G) */
+  template <bool G>
+  void sum(span<S> out, const S *const *in, std::size_t n, const S *g) {
+    rt_scope guard;
+    auto prof = this->profile();
+    S *o = out.data();
+    bool sil = out.size() > 0;
+    for (std::size_t i = 0; i < out.size(); i += tile) {
+      std::size_t t = out.size() - i < tile ? out.size() - i : tile;
+      bool first = true;
+      for (std::size_t k = 0; k < n; k++) {
+        const S *x = in[k] + i;
+        if ((!G || std::isfinite(g[k])) && x[0] == 0 &&
+            silent(span<const S>(x, t)))
+          continue;
+        if (first) {
+          if (G)
+            simd::mul(x, g[k], o + i, t);
+          else
+            std::copy(x, x + t, o + i);
+          first = false;
+        } else if (G)
+          simd::muladd(x, g[k], o + i, o + i, t);
+        else
+          simd::add(o + i, x, o + i, t);
+      }
+      if (first)
+        std::fill(o + i, o + i + t, 0);
+      sil = sil && first;
+    }
+    this->silent(sil);
   }
 
 public:
@@ -255,46 +1075,215 @@ public:
   */
   Mix(std::size_t vsize = def_vsize) : SndBase<S>(vsize){};
 
+  /** Mixer \n
+      out: caller-provided output \n
+      in: first input signal \n
+      args: any number of other signal inputs \n
+      returns out, trimmed to the shortest input size
+  */
+  template <typename... Ts>
+  span<S> operator()(span<S> out, span<const S> in, const Ts &... args) {
+    const S *p[] = {in.data(), span<const S>(args).data()...};
+    out = out.first(minsize(in.size(), args...));
+    sum<false>(out, p, sizeof...(Ts) + 1, nullptr);
+    return out;
+  }
+
   /** Mixer \n
       in: first input signal \n
       args: any number of other signal inputs
   */
   template <typename... Ts>
-  const std::vector<S> &operator()(const std::vector<S> &in, Ts... args) {
-    auto &s = get_sig();
-    s.resize(in.size());
-    std::fill(s.begin(), s.end(), 0);
-    return mix(s, in, args...);
+  const sig_vector<S> &operator()(span<const S> in, const Ts &... args) {
+    (*this)(this->sig_span(minsize(in.size(), args...)), in, args...);
+    return this->vector();
+  }
+
+  /** Weighted mixer \n
+      out: caller-provided output \n
+      g: input gains \n
+      in: input signals \n
+      returns out, trimmed to the shortest input size
+  */
+  template <std::size_t N>
+  span<S> operator()(span<S> out, const std::array<S, N> &g,
+                     const channels<S, N> &in) {
+    static_assert(N > 0, "Mix: no inputs");
+    const S *p[N];
+    std::size_t n = out.size();
+    for (std::size_t k = 0; k < N; k++) {
+      p[k] = in[k].data();
+      n = in[k].size() < n ? in[k].size() : n;
+    }
+    out = out.first(n);
+    sum<true>(out, p, N, g.data());
+    return out;
+  }
+
+  /** Weighted mixer \n
+      g: input gains \n
+      in: input signals
+  */
+  template <std::size_t N>
+  const sig_vector<S> &operator()(const std::array<S, N> &g,
+                                  const channels<S, N> &in) {
+    std::size_t n = in[0].size();
+    for (auto &s : in)
+      n = s.size() < n ? s.size() : n;
+    (*this)(this->sig_span(n), g, in);
+    return this->vector();
+  }
+};
+
+/** Bus class \n
+    mixer for a number of inputs set at run time, with gain
+    ramps \n
+    S: sample type \n
+    inputs are given as a list of signals, e.g. the outputs of
+    a pool of voices, each with a gain that is ramped linearly
+    from its previous value over each block. Inputs are mixed in
+    a single pass over the output, as with Mix, and silent inputs
+    are left out.
+*/
+template <typename S = float> class Bus : public SndBase<S> {
+  static constexpr std::size_t tile = 256;
+  std::vector<S> gs;
+  std::size_t used;
+  std::array<S, tile> ix;
+
+  static std::size_t minsize(span<const span<const S>> in, std::size_t n) {
+    for (auto &s : in)
+      n = s.size() < n ? s.size() : n;
+    return n;
+  }
+
+public:
+  /** Constructor \n
+      maxin: number of inputs to reserve gain memory for \n
+      vsize: signal vector size
+  */
+  Bus(std::size_t maxin = 0, std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), gs(maxin), used(0) {
+    std::iota(ix.begin(), ix.end(), S(0));
+  }
+
+  /** Gain setting \n
+      g: gains, applied from the next block without a ramp
+  */
+  void gains(span<const S> g) {
+    if (gs.size() < g.size())
+      rt_resize(gs, g.size());
+    used = g.size() < gs.size() ? g.size() : gs.size();
+    std::copy(g.begin(), g.begin() + used, gs.begin());
+  }
+
+  /** Mixer \n
+      out: caller-provided output \n
+      in: input signals \n
+      g: input gains, reached at the end of the block; an input
+      added since the last call starts at its gain. The number of
+      inputs mixed is the smaller of the two list sizes (and, in
+      AURORA_RT_SAFE builds, no more than reserved at construction) \n
+      returns out, trimmed to the shortest input size
+  */
+  span<S> operator()(span<S> out, span<const span<const S>> in,
+                     span<const S> g) {
+    rt_scope guard;
+    auto prof = this->profile();
+    S pos[tile], r[tile];
+    std::size_t n = in.size() < g.size() ? in.size() : g.size();
+    if (gs.size() < n)
+      rt_resize(gs, n);
+    n = n < gs.size() ? n : gs.size();
+    for (std::size_t k = used; k < n; k++)
+      gs[k] = g[k];
+    used = n;
+    out = out.first(minsize(in.first(n), out.size()));
+    S *o = out.data();
+    S incr = out.size() ? S(1) / out.size() : S(0);
+    bool sil = out.size() > 0;
+    for (std::size_t i = 0; i < out.size(); i += tile) {
+      std::size_t t = out.size() - i < tile ? out.size() - i : tile;
+      bool first = true;
+      simd::add(ix.data(), S(i), pos, t);
+      for (std::size_t k = 0; k < n; k++) {
+        const S *x = in[k].data() + i;
+        S g0 = gs[k], dg = (g[k] - g0) * incr;
+        if (std::isfinite(g0) && std::isfinite(g[k]) && x[0] == 0 &&
+            silent(span<const S>(x, t)))
+          continue;
+        if (dg == 0) {
+          if (first)
+            simd::mul(x, g0, o + i, t);
+          else
+            simd::muladd(x, g0, o + i, o + i, t);
+        } else {
+          simd::scaloffs(pos, dg, g0, r, t);
+          if (first)
+            simd::mul(x, r, o + i, t);
+          else
+            simd::muladd(x, r, o + i, o + i, t);
+        }
+        first = false;
+      }
+      if (first)
+        std::fill(o + i, o + i + t, 0);
+      sil = sil && first;
+    }
+    std::copy(g.begin(), g.begin() + n, gs.begin());
+    this->silent(sil);
+    return out;
+  }
+
+  /** Mixer \n
+      in: input signals \n
+      g: input gains (see above)
+  */
+  const sig_vector<S> &operator()(span<const span<const S>> in,
+                                  span<const S> g) {
+    std::size_t n = in.size() < g.size() ? in.size() : g.size();
+    (*this)(this->sig_span(n ? minsize(in.first(n), in[0].size()) : 0), in,
+            g);
+    return this->vector();
   }
 };
 
+/** circular table index wrap \n
+    k: index in [0, 2n) \n
+    n: table size \n
+    returns k modulo n, computed with a mask instead of a branch
+*/
+inline size_t wrap_index(size_t k, size_t n) {
+  return k - (n & -(size_t)(k >= n));
+}
+
 /** linear interpolation circular table lookup \n
     S: sample type \n
     pos: reading position (no bounds check) \n
-    t: table
+    t: table \n
+    branch-free: the wraparound neighbour is selected by wrap_index()
 */
-template <typename S>
-inline S linear_interp(double pos, const std::vector<S> &t) {
+template <typename S, typename A>
+inline S linear_interp(double pos, const std::vector<S, A> &t) {
   size_t posi = (size_t)pos;
   double frac = pos - posi;
-  return t[posi] +
-         frac * ((posi != t.size() - 1 ? t[posi + 1] : t[0]) - t[posi]);
+  return t[posi] + frac * (t[wrap_index(posi + 1, t.size())] - t[posi]);
 }
 
 /** cubic interpolation circular table lookup \n
     S: sample type \n
     pos: reading position (no bounds check) \n
-    t: table
+    t: table \n
+    branch-free: the wraparound neighbours are selected by wrap_index()
 */
-template <typename S>
-inline S cubic_interp(double pos, const std::vector<S> &t) {
-  size_t posi = (size_t)pos;
+template <typename S, typename A>
+inline S cubic_interp(double pos, const std::vector<S, A> &t) {
+  size_t posi = (size_t)pos, n = t.size();
   double frac = pos - posi;
-  double a = posi == 0 ? t[t.size() - 1] : t[posi - 1];
+  double a = t[wrap_index(posi + n - 1, n)];
   double b = t[posi];
-  double c = posi != t.size() - 1 ? t[posi + 1] : t[0];
-  double d =
-      posi != t.size() - 2 ? (posi != t.size() - 1 ? t[posi + 2] : t[1]) : t[0];
+  double c = t[wrap_index(posi + 1, n)];
+  double d = t[wrap_index(posi + 2, n)];
   double tmp = d + 3.f * b;
   double fracsq = frac * frac;
   double fracb = frac * fracsq;
@@ -307,8 +1296,8 @@ inline S cubic_interp(double pos, const std::vector<S> &t) {
     pos: reading position \n
     t: table
 */
-template <typename S>
-inline S linear_interp_lim(double pos, const std::vector<S> &t) {
+template <typename S, typename A>
+inline S linear_interp_lim(double pos, const std::vector<S, A> &t) {
   pos = pos < 0 ? 0 : (pos < t.size() ? pos : t.size() - 1);
   size_t posi = (size_t)pos;
   return t[posi] +
@@ -320,8 +1309,8 @@ inline S linear_interp_lim(double pos, const std::vector<S> &t) {
     pos: reading position (no bounds check) \n
     t: table
 */
-template <typename S>
-inline S cubic_interp_lim(double pos, const std::vector<S> &t) {
+template <typename S, typename A>
+inline S cubic_interp_lim(double pos, const std::vector<S, A> &t) {
   pos = pos < 0 ? 0 : (pos < t.size() ? pos : t.size() - 1);
   size_t posi = (size_t)pos;
   if (posi > 0 && posi < t.size() - 2) {
@@ -160,11 +160,26 @@ namespace Aurora {
       std::vector<specdata<S>> spec;
       std::size_t hs;
       std::size_t fcnt;
+#ifdef AURORA_PROFILE
+      prof_probe prb;
+#endif
 
     protected:
       std::vector<specdata<S>> &get_spec(){ return spec; }
       void fcount_incr() { fcnt++; }
 
+      /** Profiling scope \n
+	  returns a scope timing the current processing call
+	  (AURORA_PROFILE builds, see Profile.h; no-op otherwise)
+      */
+      prof_scope profile() const {
+#ifdef AURORA_PROFILE
+	return prof_scope(prb, this, typeid(*this));
+#else
+	return prof_scope();
+#endif
+      }
+
     public:
         /** Constructor \n
         size: spectral frame size
@@ -173,6 +188,10 @@ namespace Aurora {
       SpecBase(std::size_t size = def_fftsize) :
       spec(size/2 + 1), fcnt(0) { };
 
+#ifdef AURORA_PROFILE
+      virtual ~SpecBase() {}
+#endif
+
       /** spectral frame size 
        */
       std::size_t size() const { return (spec.size() - 1)*2; }
@@ -210,7 +229,8 @@ namespace Aurora {
         coefs: number of cepstral coeffs retained \n
         returns the spectral envelope (non-negative frequencies only)
      */
-    const std::vector<S> &operator()(const std::vector<specdata<S>> &in, std::size_t coefs){
+    const sig_vector<S> &operator()(const std::vector<specdata<S>> &in, std::size_t coefs){
+      auto prof = this->profile();
       std::size_t n = 0;
       auto &mags = get_sig();
       std::transform(in.begin(), in.end(), mags.begin(),
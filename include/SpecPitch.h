@@ -108,7 +108,7 @@ template <typename S = float> class SpecPitch {
      rate: analysis rate in frames/sec
  */
  SpecPitch(std::size_t npeaks = def_fftsize/4, S rate = def_sr/def_hsize) :
-  peaks(npeaks), framecount(0), ifacts(npeaks), cps(260), ts(1/rate),
+  peaks(npeaks), ifacts(npeaks), framecount(0), cps(260), ts(1/rate),
     y(260), c(0), t(0)  { }
 
 
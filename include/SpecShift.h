@@ -70,7 +70,6 @@ namespace Aurora {
 	for(auto &m : senv) 
 	  if(m > max) max = m;
 	for(auto &amp : ftmp) {
-	  float cf = n/float(size);
 	  amp = spec[n].amp();
 	  if(senv[n] > 0)	
 	    amp *= max/senv[n++];
@@ -82,9 +81,9 @@ namespace Aurora {
 	int k = round(fscale*n + offsr);
 	int j = round((1/forscale)*n - forshift);
 	auto &senv = ceps.vector();
-	if(k > 0  && k < spec.size()) {
-	  if(preserve && j > 0  && j < spec.size()
-	     && !isnan(senv[j])) {
+	if(k > 0  && k < (int) spec.size()) {
+	  if(preserve && j > 0  && j < (int) spec.size()
+	     && !std::isnan(senv[j])) {
 	      buf[k].amp(ftmp[n]*senv[j]);
 	  }
 	  else buf[k].amp(bin.amp());
@@ -106,6 +105,7 @@ namespace Aurora {
 					       S scl, S shft = 0, S forscl = 0,
 					       S forshft = 0) {
       if(obj.framecount() > this->framecount()) {
+        auto prof = this->profile();
 	fcount_incr();
         return shift(obj.frame(),scl,shft,forscl,forshft);
       } else return get_spec();
@@ -114,6 +114,7 @@ namespace Aurora {
     const std::vector<specdata<S>> &operator()(const std::vector<specdata<S>> &spec,
 					       S scl, S shft = 0, S forscl = 0,
 					       S forshft = 0) {
+        auto prof = this->profile();
         return shift(spec,scl,shft,forscl,forshft);
     }
 
@@ -43,15 +43,15 @@ namespace Aurora {
     using SpecBase<S>::get_spec;
     using SpecBase<S>::fcount_incr;
     std::size_t hs;
-    std::vector<S> buf;
-    std::vector<S> wbuf;
+    aligned_vector<S> buf;
+    aligned_vector<S> wbuf;
     std::vector<S> oph;
     const std::vector<S> &win;
     FFT<S> fft;
     S fac, c;
     std::size_t dm, hnum, pos;
  
-    void analysis(const std::vector<S> &in) {
+    void analysis(const aligned_vector<S> &in) {
       std::size_t n = 0;
       auto &v = fft(in);
       for(auto &s : get_spec()) {
@@ -80,7 +80,8 @@ namespace Aurora {
         in: signal input \n
         returns the current spectral frame (non=negative frequencies only)
     */
-    const std::vector<specdata<S>> &operator()(const std::vector<S> &in) {
+    const std::vector<specdata<S>> &operator()(span<const S> in) {
+      auto prof = this->profile();
       std::size_t vsize = in.size();
       if(vsize > hs) vsize = hs;
       std::size_t samps = vsize + pos;
@@ -133,7 +134,7 @@ namespace Aurora {
   template <typename S = float>
     class SpecSynth : public SndBase<S> {
     using SndBase<S>::get_sig;
-    std::vector<std::vector<S>> buffers;
+    std::vector<aligned_vector<S>> buffers;
     std::vector<std::complex<S>> spec;
     std::vector<double> ph;
     const std::vector<S> &win;
@@ -166,7 +167,7 @@ namespace Aurora {
   SpecSynth(const std::vector<S> &window, std::size_t hsiz = def_hsize,
 	    S fs = def_sr, std::size_t vsize = def_vsize) :
     SndBase<S>(vsize), buffers(window.size()/hsiz,
-			       std::vector<S>(window.size())),
+			       aligned_vector<S>(window.size())),
       spec(window.size()/2 + 1), ph(window.size()/2 + 1), win(window),
       fft(window.size(), !packed), dm(window.size()/hsiz),
       hsize(hsiz), count(dm), fac(twopi*hsiz/fs),
@@ -177,12 +178,14 @@ namespace Aurora {
 
 
     /** Spectral stream synthesis \n
+        out: caller-provided output \n
         in: input spectral frame  \n
-        returns the output signal vector
+        returns out
     */    
-    const std::vector<S> &operator() (const std::vector<specdata<S>> &in) {  
+    span<S> operator() (span<S> out, const std::vector<specdata<S>> &in) {  
+      auto prof = this->profile();
       std::size_t size = win.size();
-      for(auto &ss : get_sig()) {
+      for(auto &ss : out) {
 	ss = 0;
 	std::size_t j = 0;
 	for (auto &cnt : count) { 
@@ -201,6 +204,15 @@ namespace Aurora {
 	  j++;
 	}
       }
+      return out;
+    }
+
+    /** Spectral stream synthesis \n
+        in: input spectral frame  \n
+        returns the output signal vector
+    */    
+    const sig_vector<S> &operator() (const std::vector<specdata<S>> &in) {  
+      (*this)(this->sig_span(0), in);
       return get_sig();
     }
     
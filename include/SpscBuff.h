@@ -0,0 +1,213 @@
+// SpscBuff.h
+// Lock-free circular buffer
+// single producer, single consumer
+//
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_SPSCBUFF_
+#define _AURORA_SPSCBUFF_
+
+#include "SndBase.h"
+#include <array>
+#include <atomic>
+
+namespace Aurora {
+
+/** SpscBuff class \n
+    lock-free circular buffer for passing audio between two
+    threads \n
+    S: sample type \n
+    one thread (the producer) writes to the buffer and another
+    (the consumer) reads from it, with no locking. Each side
+    owns one index, published with release ordering and read by
+    the other side with acquire ordering, so that samples are
+    always visible before the index that covers them. The indices
+    are held in separate cache lines, each with the side's own
+    copy of the other index, which is only refreshed when the
+    cached value does not allow the request to be met. Writes never
+    overwrite unread samples and reads never go past the written
+    ones; calls return the number of samples actually transferred.
+*/
+template <typename S> class SpscBuff : public SndBase<S> {
+  aligned_vector<S> b;
+  /* producer line: write index and cached read index */
+  alignas(def_align) std::atomic<std::size_t> wp;
+  std::size_t rpc;
+  /* consumer line: read index and cached write index */
+  alignas(def_align) std::atomic<std::size_t> rp;
+  std::size_t wpc;
+
+  /* indices run freely, positions are taken modulo the size */
+  template <typename T>
+  std::array<span<T>, 2> regions(T *p, std::size_t pos, std::size_t n) {
+    std::size_t beg = pos % b.size();
+    std::size_t len = b.size() - beg;
+    if (n <= len)
+      return {span<T>(p + beg, n), span<T>()};
+    return {span<T>(p + beg, len), span<T>(p, n - len)};
+  }
+
+public:
+  /** Constructor \n
+      bsize: buffer size \n
+      vsize: signal vector size
+  */
+  SpscBuff(std::size_t bsize, std::size_t vsize = def_vsize)
+      : SndBase<S>(vsize), b(bsize ? bsize : 1), wp(0), rpc(0), rp(0),
+        wpc(0){};
+
+  /** Buffer size query \n
+      returns the buffer size
+  */
+  std::size_t bsize() const { return b.size(); }
+
+  /** Buffer size setting \n
+      n: new buffer size \n
+      clears the buffer, not to be called while either
+      thread is using it
+  */
+  void bsize(std::size_t n) {
+    b.resize(n ? n : 1);
+    reset();
+  }
+
+  /** Reset \n
+      empties the buffer, not to be called while either
+      thread is using it
+  */
+  void reset() {
+    std::fill(b.begin(), b.end(), 0);
+    wp.store(0, std::memory_order_relaxed);
+    rp.store(0, std::memory_order_relaxed);
+    rpc = wpc = 0;
+  }
+
+  /** Fill query \n
+      returns the number of samples available for reading
+      (exact on the consumer side, a lower bound elsewhere)
+  */
+  std::size_t fill() const {
+    std::size_t r = rp.load(std::memory_order_relaxed);
+    return wp.load(std::memory_order_acquire) - r;
+  }
+
+  /** Space query \n
+      returns the number of samples that can be written
+      (exact on the producer side, a lower bound elsewhere)
+  */
+  std::size_t space() const {
+    std::size_t w = wp.load(std::memory_order_relaxed);
+    return b.size() - (w - rp.load(std::memory_order_acquire));
+  }
+
+  /** Write regions (producer) \n
+      n: requested number of samples \n
+      returns up to n samples of free buffer memory, as two
+      contiguous segments (the second one is empty unless the
+      region wraps around), to be written directly and then
+      published by commit()
+  */
+  std::array<span<S>, 2> write_regions(std::size_t n) {
+    std::size_t w = wp.load(std::memory_order_relaxed);
+    if (b.size() - (w - rpc) < n)
+      rpc = rp.load(std::memory_order_acquire);
+    std::size_t free = b.size() - (w - rpc);
+    return regions(b.data(), w, n < free ? n : free);
+  }
+
+  /** Commit (producer) \n
+      n: number of samples written to the write regions \n
+      makes the samples available to the consumer
+  */
+  void commit(std::size_t n) {
+    wp.store(wp.load(std::memory_order_relaxed) + n,
+             std::memory_order_release);
+  }
+
+  /** Read regions (consumer) \n
+      n: requested number of samples \n
+      returns up to n samples of buffered audio, as two
+      contiguous segments (the second one is empty unless the
+      region wraps around), to be read directly and then
+      released by consume()
+  */
+  std::array<span<const S>, 2> read_regions(std::size_t n) {
+    std::size_t r = rp.load(std::memory_order_relaxed);
+    if (wpc - r < n)
+      wpc = wp.load(std::memory_order_acquire);
+    std::size_t avail = wpc - r;
+    return regions<const S>(b.data(), r, n < avail ? n : avail);
+  }
+
+  /** Consume (consumer) \n
+      n: number of samples read from the read regions \n
+      frees their memory for the producer
+  */
+  void consume(std::size_t n) {
+    rp.store(rp.load(std::memory_order_relaxed) + n,
+             std::memory_order_release);
+  }
+
+  /** Buffer input (producer) \n
+      in: audio input \n
+      returns the number of samples written, which is less
+      than the input size if the buffer is full
+  */
+  std::size_t operator()(span<const S> in) {
+    auto r = write_regions(in.size());
+    std::copy(in.begin(), in.begin() + r[0].size(), r[0].begin());
+    std::copy(in.begin() + r[0].size(),
+              in.begin() + r[0].size() + r[1].size(), r[1].begin());
+    commit(r[0].size() + r[1].size());
+    return r[0].size() + r[1].size();
+  }
+
+  /** Buffer output (consumer) \n
+      out: caller-provided output, filled from the buffer \n
+      returns out, trimmed to the number of samples read
+  */
+  span<S> operator()(span<S> out) {
+    auto r = read_regions(out.size());
+    std::copy(r[0].begin(), r[0].end(), out.begin());
+    std::copy(r[1].begin(), r[1].end(), out.begin() + r[0].size());
+    consume(r[0].size() + r[1].size());
+    return out.first(r[0].size() + r[1].size());
+  }
+
+  /** Buffer output (consumer) \n
+      returns vsize() samples of audio from buffer, padded with
+      zeros if fewer were available
+  */
+  const sig_vector<S> &operator()() {
+    span<S> out = this->sig_span(0);
+    std::size_t n = (*this)(out).size();
+    std::fill(out.begin() + n, out.end(), 0);
+    return this->vector();
+  }
+};
+} // namespace Aurora
+
+#endif // _AURORA_SPSCBUFF_
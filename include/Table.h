@@ -0,0 +1,215 @@
+// Table.h:
+// Function table with guard points
+// Branch-free interpolating lookups
+//
+// (c) V Lazzarini, 2021
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+// 1. Redistributions of source code must retain the above copyright notice,
+// this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+// this list of conditions and the following disclaimer in the documentation
+// and/or other materials provided with the distribution.
+// 3. Neither the name of the copyright holder nor the names of its contributors
+// may be used to endorse or promote products derived from this software without
+// specific prior written permission.
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE
+
+#ifndef _AURORA_TABLE_
+#define _AURORA_TABLE_
+
+#include "SndBase.h"
+#include "Simd.h"
+
+namespace Aurora {
+
+/** Table class \n
+    Circular function table with guard points \n
+    S: sample type \n
+    The data is stored with wrap copies around it: one point
+    before (t[-1] == t[n-1]) and three after (t[n+j] == t[j]), so
+    that linear, cubic and Hermite lookups read their neighbours
+    without testing for wraparound, for any position in [0, n].
+    The data starts on an AURORA_ALIGN boundary.
+*/
+template <typename S = float> class Table {
+  aligned_vector<S> mem;
+  std::size_t len;
+
+public:
+  /** number of guard points before and after the data */
+  static constexpr std::size_t gbeg = 1, gend = 3;
+
+  /** memory before the data (front guard point and alignment) */
+  static constexpr std::size_t pad =
+      def_align / sizeof(S) > gbeg ? def_align / sizeof(S) : gbeg;
+
+  /** Constructor \n
+      n: table size (zero-filled)
+  */
+  explicit Table(std::size_t n = 0) : mem(pad + n + gend), len(n) {}
+
+  /** Constructor \n
+      src: table data
+  */
+  explicit Table(span<const S> src) : Table(src.size()) {
+    S *t = data();
+    for (std::size_t n = 0; n < len; n++)
+      t[n] = src[n];
+    guard();
+  }
+
+  /** Constructor \n
+      src: table data
+  */
+  explicit Table(const std::vector<S> &src) : Table(span<const S>(src)) {}
+
+  /** Table size (excluding guard points) */
+  std::size_t size() const { return len; }
+
+  /** Data access (t[-1] to t[n+2] are valid) */
+  S *data() { return mem.data() + pad; }
+  const S *data() const { return mem.data() + pad; }
+
+  S &operator[](std::size_t n) { return data()[n]; }
+  const S &operator[](std::size_t n) const { return data()[n]; }
+
+  S *begin() { return data(); }
+  S *end() { return data() + len; }
+  const S *begin() const { return data(); }
+  const S *end() const { return data() + len; }
+
+  /** Resize the table (data is zeroed) \n
+      n: new size
+  */
+  void resize(std::size_t n) {
+    mem.assign(pad + n + gend, 0);
+    len = n;
+  }
+
+  /** Update the guard points, after the data has been written */
+  void guard() {
+    if (!len)
+      return;
+    S *t = data();
+    t[-1] = t[len - 1];
+    for (std::size_t j = 0; j < gend; j++)
+      t[len + j] = t[j % len];
+  }
+
+  /** Linear interpolation lookup \n
+      pos: reading position in [0, n] (no bounds check)
+  */
+  S linear(double pos) const {
+    const S *t = data();
+    std::size_t k = (std::size_t)pos;
+    double frac = pos - k;
+    return t[k] + frac * (t[k + 1] - t[k]);
+  }
+
+  /** Cubic (Lagrange) interpolation lookup \n
+      pos: reading position in [0, n] (no bounds check)
+  */
+  S cubic(double pos) const {
+    const S *t = data();
+    std::size_t k = (std::size_t)pos;
+    double f = pos - k;
+    double a = t[k - 1], b = t[k], c = t[k + 1], d = t[k + 2];
+    double e = d + 3 * b;
+    return (((e - a - 3 * c) / 6 * f + (a + c) / 2 - b) * f + c -
+            (2 * a + e) / 6) *
+               f +
+           b;
+  }
+
+  /** Hermite (Catmull-Rom) interpolation lookup \n
+      pos: reading position in [0, n] (no bounds check)
+  */
+  S hermite(double pos) const {
+    const S *t = data();
+    std::size_t k = (std::size_t)pos;
+    double f = pos - k;
+    double a = t[k - 1], b = t[k], c = t[k + 1], d = t[k + 2];
+    return ((((d - a) / 2 + 1.5 * (b - c)) * f + a - 2.5 * b + 2 * c -
+             d / 2) *
+                f +
+            (c - a) / 2) *
+               f +
+           b;
+  }
+
+  /** Linear interpolation lookup for a block of positions \n
+      out: caller-provided output \n
+      pos: reading positions in [0, n] (no bounds check) \n
+      returns out, trimmed to the input size
+  */
+  span<S> linear(span<S> out, span<const S> pos) const {
+    out = out.first(pos.size());
+    simd::lerp(data(), pos.data(), out.data(), out.size());
+    return out;
+  }
+
+  /** Cubic interpolation lookup for a block of positions \n
+      out: caller-provided output \n
+      pos: reading positions in [0, n] (no bounds check) \n
+      returns out, trimmed to the input size
+  */
+  span<S> cubic(span<S> out, span<const S> pos) const {
+    out = out.first(pos.size());
+    simd::cubic(data(), pos.data(), out.data(), out.size());
+    return out;
+  }
+
+  /** Hermite interpolation lookup for a block of positions \n
+      out: caller-provided output \n
+      pos: reading positions in [0, n] (no bounds check) \n
+      returns out, trimmed to the input size
+  */
+  span<S> hermite(span<S> out, span<const S> pos) const {
+    out = out.first(pos.size());
+    simd::hermite(data(), pos.data(), out.data(), out.size());
+    return out;
+  }
+};
+
+/** linear interpolation guarded table lookup \n
+    S: sample type \n
+    pos: reading position in [0, n] (no bounds check) \n
+    t: table
+*/
+template <typename S> inline S linear_interp(double pos, const Table<S> &t) {
+  return t.linear(pos);
+}
+
+/** cubic interpolation guarded table lookup \n
+    S: sample type \n
+    pos: reading position in [0, n] (no bounds check) \n
+    t: table
+*/
+template <typename S> inline S cubic_interp(double pos, const Table<S> &t) {
+  return t.cubic(pos);
+}
+
+/** Hermite interpolation guarded table lookup \n
+    S: sample type \n
+    pos: reading position in [0, n] (no bounds check) \n
+    t: table
+*/
+template <typename S> inline S hermite_interp(double pos, const Table<S> &t) {
+  return t.hermite(pos);
+}
+
+} // namespace Aurora
+
+#endif // _AURORA_TABLE_
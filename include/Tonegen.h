@@ -37,52 +37,61 @@ namespace Aurora {
     static constexpr int32_t maxlen = 0x40000000; // max tab len 2^30
     static constexpr int32_t phmsk = maxlen - 1;
     using SndBase<S>::process;
-    const std::vector<S> *tab;
+    const S *tab;
     int64_t fac;
     int lobits; // how many bits are used in indexing
     int lomask; // mask for frac extraction
     S lofac; // fac for frac extract
     
     S lookup(int64_t phs) {
-      auto &t = *tab;
+      auto t = tab;
       float frac = (phs & lomask)*lofac; // frac part of index
       int64_t ndx = (phs & phmsk) >> lobits;  // index
       S s = t[ndx] + frac*(t[ndx+1] - t[ndx]);  // lookup
       return s;
     }
 
-  public:
-  Lookup(const std::vector<S> *w = NULL, S ratio = 1,
-	    std::size_t vsize = def_vsize) : SndBase<S>(vsize),
-      tab(w), fac(ratio*maxlen), lobits(0) {
-      if(w) {	
-      for(int64_t t = tab->size()-1; (t & maxlen) == 0; t <<= 1) 
+    void bits(int64_t len) {
+      lobits = 0;
+      for(int64_t t = len; (t & maxlen) == 0; t <<= 1) 
 	lobits += 1;
       lomask = (1 << lobits) - 1;
       lofac = 1.f/(lomask + 1);
-      }    
+    }
+
+  public:
+  Lookup(const std::vector<S> *w = NULL, S ratio = 1,
+	    std::size_t vsize = def_vsize) : SndBase<S>(vsize),
+      tab(w ? w->data() : NULL), fac(ratio*maxlen), lobits(0) {
+      if(w) bits(w->size()-1);
     }
 
     void set_ratio(S r) { fac = r*maxlen; }
+    /* vector tables carry one guard point at the end */
     void set_table(const std::vector<S> *w) {
-      tab = w;
-      lobits = 0;
-      for(int64_t t = tab->size()-1; (t & maxlen) == 0; t <<= 1) 
-	lobits += 1;
-      lomask = (1 << lobits) - 1;
-      lofac = 1.f/(lomask + 1);
+      tab = w->data();
+      bits(w->size()-1);
+    }
+    void set_table(const Table<S> *w) {
+      tab = w->data();
+      bits(w->size());
     }
 
-
-    void swap_table(const std::vector<S> *w) { tab = w; }
+    void swap_table(const std::vector<S> *w) { tab = w->data(); }
+    void swap_table(const Table<S> *w) { tab = w->data(); }
       
-    const std::vector<S> &operator() (const std::vector<S> &phs) {
+    span<S> operator() (span<S> out, span<const S> phs) {
       std::size_t n  = 0;
       return process(
         [&]() {
           return lookup((phs[n++]*fac));
         },
-        phs.size());
+        out.first(phs.size()));
+    }
+
+    const sig_vector<S> &operator() (span<const S> phs) {
+      (*this)(this->sig_span(phs.size()), phs);
+      return this->vector();
     }
   };
 
@@ -151,7 +160,7 @@ class Tonegen {
   }
 
   void operator()(std::size_t vsize) { run(vsize); }
-  const std::vector<S> &wheel(std::size_t num) {
+  const sig_vector<S> &wheel(std::size_t num) {
     return wheels[num].vector();
   }
 
@@ -173,7 +182,7 @@ const SqrTab<S> Tonegen<S>::sqtab;
     std::vector<Osc<S,phase>> phs;
     Lookup<S> tread;
     std::vector<double> freq;
-    std::vector<S> mix;
+    sig_vector<S> mix;
 
     void run(std::size_t vsiz, S detun = 1.f) {
       std::size_t n = 0;
@@ -190,19 +199,18 @@ const SqrTab<S> Tonegen<S>::sqtab;
        float base = 8.175798915643707;
        for(auto &f : freq) 
 	 f = base*pow(2,n++/12.);
-        waveset.guardpoint();
 	tread.set_table(&waveset.func(freq[0]));
     }
 
-    const std::vector<S> &operator()(std::size_t vsize, S detun = 1.f) {
-      mix.resize(vsize);
+    const sig_vector<S> &operator()(std::size_t vsize, S detun = 1.f) {
+      vsize = rt_resize(mix, vsize);
       tread.vsize(vsize);
       std::fill(mix.begin(), mix.end(), 0);
       run(vsize,detun);
       return mix;
     }
 				   
-    const std::vector<S> &tone(std::size_t note, S amp) {
+    const sig_vector<S> &tone(std::size_t note, S amp) {
       if(note < 128) {
       tread.set_ratio(freq[note]/freq[note%12]);
       tread.swap_table(&waveset.func(freq[note]));      
@@ -215,7 +223,6 @@ const SqrTab<S> Tonegen<S>::sqtab;
 
     void reset(S fs, int type = SAW) {
       waveset.reset(type, fs);
-           waveset.guardpoint();   
       tread.set_table(&waveset.func(freq[0]));
       for(auto &p : phs) p.reset(fs);
     } 
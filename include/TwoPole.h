@@ -50,6 +50,15 @@ template <typename S = float, S (*FN)(S, S) = id> class TwoPole : public SndBase
   double W, Fac;
   S ff, dd;
   double piosr;
+  Tail<S> tl;
+  Smooth<S> sm;
+
+  void decay(span<const S> out) {
+    if (tl.on() && tl.quiet(D, 2) && tl.quiet(out)) {
+      D[0] = D[1] = 0;
+      tl.idle(true);
+    }
+  }
 
   S filter(S in, S *y, double *s, double w, double fac, S d, S drv, int32_t typ,
            S m) {
@@ -81,47 +90,124 @@ public:
         piosr(M_PI / fs){};
 
   /** Filter \n
+     out: caller-provided output \n
      in: input \n
      f: frequency \n
      d: damping factor (Q reciprocal) \n
      drv: overdrive amount \n
-     m: output type (0 - 2: LP(0), HP(1), BP(2))
+     m: output type (0 - 2: LP(0), HP(1), BP(2)) \n
+     returns out, trimmed to the input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in, S f, S d,
-                                   S drv = 0, S m = 0) {
+  span<S> operator()(span<S> out, span<const S> in, S f, S d, S drv = 0,
+                     S m = 0) {
     std::size_t n = 0;
     int32_t typ = m < 1 ? -1 : (m < 2 ? 0 : 1);
     m = m < 0 ? 0 : (m < 1 ? m : (m < 2 ? m - 1 : 1));
-    if (f != ff || d != dd)
-      coeffs(f, d, dd, W, Fac, ff, piosr);
-    auto pf = [&]() {
-      return filter(in[n++], Y, D, W, Fac, d, drv + 1, typ, m);
-    };
-    return process(pf, in.size());
+    out = out.first(in.size());
+    if (tl.skip(in))
+      return this->mute(out);
+    if ((f != ff || d != dd) && sm.ramp()) {
+      S f0 = ff, d0 = dd;
+      double c[3] = {W, Fac, d0};
+      out = process(
+          sm, out, c,
+          [&](double t, double *cn) {
+            S dt = sm.at(d0, d, t);
+            coeffs(sm.at(f0, f, t), dt, dd, cn[0], cn[1], ff, piosr);
+            cn[2] = dt;
+          },
+          [&](std::size_t i, const double *c) {
+            return filter(in[i], Y, D, c[0], c[1], c[2], drv + 1, typ, m);
+          });
+      W = c[0];
+      Fac = c[1];
+    } else {
+      if (f != ff || d != dd)
+        coeffs(f, d, dd, W, Fac, ff, piosr);
+      auto pf = [&]() {
+        return filter(in[n++], Y, D, W, Fac, d, drv + 1, typ, m);
+      };
+      out = process(pf, out);
+    }
+    decay(out);
+    return out;
   }
 
   /** Filter \n
+     out: caller-provided output \n
      in: input \n
      f: frequency \n
      d: damping factor (Q reciprocal) \n
      drv: overdrive amount \n
-     m: output type (0 - 2: LP(0), HP(1), BP(2))
+     m: output type (0 - 2: LP(0), HP(1), BP(2)) \n
+     returns out, trimmed to the shortest input size
   */
-  const std::vector<S> &operator()(const std::vector<S> &in,
-                                   const std::vector<S> &f, S d, S drv = 0,
-                                   S m = 0) {
-
+  span<S> operator()(span<S> out, span<const S> in, span<const S> f, S d,
+                     S drv = 0, S m = 0) {
     std::size_t n = 0;
     int32_t typ = m < 1 ? -1 : (m < 2 ? 0 : 1);
     m = m < 0 ? 0 : (m < 1 ? m : (m < 2 ? m - 1 : 1));
+    out = out.first(in.size() < f.size() ? in.size() : f.size());
+    if (tl.skip(in.first(out.size())))
+      return this->mute(out);
     auto pf = [&]() {
       if (f[n] != ff || d != dd)
         coeffs(f[n], d, dd, W, Fac, ff, piosr);
       return filter(in[n++], Y, D, W, Fac, d, drv + 1, typ, m);
     };
-    return process(pf, in.size() < f.size() ? in.size() : f.size());
+    out = process(pf, out);
+    decay(out);
+    return out;
+  }
+
+  /** Filter \n
+     in: input \n
+     f: frequency \n
+     d: damping factor (Q reciprocal) \n
+     drv: overdrive amount \n
+     m: output type (0 - 2: LP(0), HP(1), BP(2))
+  */
+  const sig_vector<S> &operator()(span<const S> in, S f, S d, S drv = 0,
+                                  S m = 0) {
+    (*this)(this->sig_span(in.size()), in, f, d, drv, m);
+    return this->vector();
+  }
+
+  /** Filter \n
+     in: input \n
+     f: frequency \n
+     d: damping factor (Q reciprocal) \n
+     drv: overdrive amount \n
+     m: output type (0 - 2: LP(0), HP(1), BP(2))
+  */
+  const sig_vector<S> &operator()(span<const S> in, span<const S> f, S d,
+                                  S drv = 0, S m = 0) {
+    (*this)(this->sig_span(in.size() < f.size() ? in.size() : f.size()), in, f,
+            d, drv, m);
+    return this->vector();
   }
 
+  /** Parameter smoothing \n
+      k: coefficient update period in samples (0 turns smoothing off) \n
+      ex: exponential (true) or linear (false) ramps \n
+      when on, frequency and damping changes are ramped across the
+      next block by the scalar-parameter operator
+  */
+  void smooth(std::size_t k, bool ex = false) { sm.rate(k, ex); }
+
+  /** Tail detection \n
+      th: silence threshold (< 0 turns detection off) \n
+      when the filter state and output decay to within the threshold, the
+      filter goes idle and skips processing until non-silent input
+      arrives
+  */
+  void tail(S th) { tl.threshold(th); }
+
+  /** Idle state query \n
+      returns true if the filter is idle
+  */
+  bool idle() const { return tl.idle(); }
+
   /** reset the filter \n
       fs: sampling rate
    */
@@ -132,6 +218,117 @@ public:
     coeffs(ff, dd, dd, W, Fac, ff, piosr);
   }
 };
+
+/** TwoPoleN class  \n
+    Multichannel 2-pole state-variable filter \n
+    coefficients are computed once and channels
+    are processed as parallel lanes \n
+    S: sample type \n
+    N: number of channels
+*/
+template <typename S, std::size_t N, S (*FN)(S, S) = id>
+class TwoPoleN : public SndBaseN<S, N> {
+  using SndBaseN<S, N>::process;
+  using SndBaseN<S, N>::minsize;
+  double D[2][N];
+  double W, Fac;
+  S ff, dd;
+  double piosr;
+
+  void filter(const S *x, S *o, double *s0, double *s1, S d, S drv,
+              int32_t typ, S m) {
+    for (std::size_t c = 0; c < N; c++) {
+      S hp = (x[c] - (d + W) * s0[c] - s1[c]) * Fac;
+      S u = W * FN(hp, drv);
+      S bp = u + s0[c];
+      s0[c] = bp + u;
+      u = W * FN(bp, drv);
+      S lp = u + s1[c];
+      s1[c] = lp + u;
+      o[c] = typ == -1 ? lp * (1 - m) + hp * m : hp * (1 - m) + bp * m;
+    }
+  }
+
+  void coeffs(S f, S d) {
+    W = std::tan(f * piosr);
+    Fac = 1. / (1. + W * d + W * W);
+    ff = f;
+    dd = d;
+  }
+
+  template <typename F>
+  channels<S, N> run(F &&upd, const channels<S, N> &in, std::size_t sz, S d,
+                     S drv, S m) {
+    double s0[N], s1[N];
+    std::size_t n = 0;
+    int32_t typ = m < 1 ? -1 : (m < 2 ? 0 : 1);
+    m = m < 0 ? 0 : (m < 1 ? m : (m < 2 ? m - 1 : 1));
+    std::copy(D[0], D[0] + N, s0);
+    std::copy(D[1], D[1] + N, s1);
+    auto o = process(
+        [&](const S *x, S *y) {
+          upd(n++);
+          filter(x, y, s0, s1, d, drv + 1, typ, m);
+        },
+        in, sz);
+    std::copy(s0, s0 + N, D[0]);
+    std::copy(s1, s1 + N, D[1]);
+    return o;
+  }
+
+public:
+  /** Constructor \n
+   sr: sampling rate \n
+   vsize: vector size
+  */
+  TwoPoleN(S fs = def_sr, std::size_t vsize = def_vsize)
+      : SndBaseN<S, N>(vsize), D{{0}}, W(0), Fac(0), ff(0), dd(0),
+        piosr(M_PI / fs){};
+
+  /** Filter \n
+     in: input channels \n
+     f: frequency \n
+     d: damping factor (Q reciprocal) \n
+     drv: overdrive amount \n
+     m: output type (0 - 2: LP(0), HP(1), BP(2)) \n
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, S f, S d, S drv = 0,
+                            S m = 0) {
+    if (f != ff || d != dd)
+      coeffs(f, d);
+    return run([](std::size_t) {}, in, minsize(in), d, drv, m);
+  }
+
+  /** Filter \n
+     in: input channels \n
+     f: frequency signal (shared by all channels) \n
+     d: damping factor (Q reciprocal) \n
+     drv: overdrive amount \n
+     m: output type (0 - 2: LP(0), HP(1), BP(2)) \n
+     returns the output channels
+  */
+  channels<S, N> operator()(const channels<S, N> &in, span<const S> f, S d,
+                            S drv = 0, S m = 0) {
+    std::size_t sz = minsize(in);
+    return run(
+        [&](std::size_t n) {
+          if (f[n] != ff || d != dd)
+            coeffs(f[n], d);
+        },
+        in, sz < f.size() ? sz : f.size(), d, drv, m);
+  }
+
+  /** reset the filter \n
+      fs: sampling rate
+   */
+  void reset(S fs) {
+    piosr = M_PI / fs;
+    std::fill(D[0], D[0] + N, 0);
+    std::fill(D[1], D[1] + N, 0);
+    coeffs(ff, dd);
+  }
+};
 } // namespace Aurora
 
 #endif //_AURORA_TWOPOLE_